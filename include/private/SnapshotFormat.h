@@ -0,0 +1,94 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _SNAPSHOT_FORMAT_H_
+#define _SNAPSHOT_FORMAT_H_
+
+#include <stdint.h>
+
+#include "Environment.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Binary image of a database shared by configd (writer) and libconfigd (reader).
+ *
+ * Layout (native byte order)
+ *   SnapshotHeader
+ *   String table  : deduplicated bytes referenced by (offset, length)
+ *   Index         : one SnapshotEntry per "category.config". In shared image, entries are sorted
+ *                   by full name (memcmp order) for binary search of libconfigd. Snapshot of
+ *                   a JSON file is only decoded as a whole, so its entries are in database order.
+ *   Values        : tagged binary encoding of each config value
+ *
+ * Values
+ *   Null, False, True  : tag only
+ *   Integer, Double    : tag + int64_t / double
+ *   RawNumber, String  : tag + uint32_t offset + uint32_t length into string table
+ *   Array              : tag + uint32_t count + values
+ *   Object             : tag + uint32_t count + (uint32_t offset + uint32_t length + value) * count
+ */
+#define SNAPSHOT_MAGIC          "CFGS"
+#define SNAPSHOT_MAGIC_LENGTH   4
+#define SNAPSHOT_VERSION        2
+
+// Unified database published by configd for libconfigd clients.
+// Configs which require "read" permission are not in it.
+#define SNAPSHOT_SHARED_PATH    INSTALL_RUNTIMEINFODIR "/configd_unified_db.snapshot"
+
+typedef struct {
+    char magic[SNAPSHOT_MAGIC_LENGTH];
+    uint32_t version;
+    uint64_t generation;        // Increased whenever shared snapshot is published
+    uint64_t sourceInode;       // Identity of JSON file which the image is made from
+    uint64_t sourceSize;
+    int64_t sourceMtimeSec;
+    int64_t sourceMtimeNsec;
+    uint32_t stringTableOffset;
+    uint32_t stringTableSize;
+    uint32_t indexOffset;
+    uint32_t entryCount;
+    uint32_t valueOffset;
+    uint32_t valueSize;
+} SnapshotHeader;
+
+typedef struct {
+    uint32_t categoryOffset;
+    uint32_t categoryLength;
+    uint32_t configOffset;
+    uint32_t configLength;
+    uint32_t valueOffset;
+} SnapshotEntry;
+
+typedef enum {
+    SnapshotValueTag_Null = 0,
+    SnapshotValueTag_False,
+    SnapshotValueTag_True,
+    SnapshotValueTag_Integer,
+    SnapshotValueTag_Double,
+    SnapshotValueTag_RawNumber,
+    SnapshotValueTag_String,
+    SnapshotValueTag_Array,
+    SnapshotValueTag_Object
+} SnapshotValueTag;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SNAPSHOT_FORMAT_H_
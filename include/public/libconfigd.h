@@ -68,6 +68,29 @@ bool config_loadConfigsFromFile(char *path, char *fileName, int32_t *errorCode);
  */
 bool config_setConfigs(jvalue_ref configsObj, int32_t *errorCode);
 
+/**
+ * Start a batch of config_setConfigs.
+ *
+ * A batch belongs to the calling thread. config_setConfigs of the thread in the
+ * batch is sent to configd as one merged setConfigs in config_commitSetConfigs.
+ * Getters of the thread return its new values immediately. Other threads and
+ * key watchers see them when the outermost commit publishes them.
+ * Batches can be nested. Only the outermost commit sends the request.
+ *
+ * @param errorCode
+ */
+bool config_beginSetConfigs(int32_t *errorCode);
+
+/**
+ * Finish a batch started by config_beginSetConfigs.
+ *
+ * If the merged setConfigs fails, all configs changed in the batch are
+ * restored to previous values.
+ *
+ * @param errorCode
+ */
+bool config_commitSetConfigs(int32_t *errorCode);
+
 /**
  * Get configs for requested configs
  *
@@ -131,6 +154,33 @@ void config_addWatch(configdNotify func, void *watch_context);
  */
 bool config_removeWatch(configdNotify func);
 
+/**
+ * Notify when the cached value of specific configs is changed.
+ *
+ * Unlike config_addWatch(), func is called only if any matching config is actually changed
+ * in local cache and changedObjects contains matching configs only. Removed configs have
+ * null value.
+ *
+ * The same func can be registered for multiple config names. The same pair of configNameBuf
+ * and func should not be registered more than once.
+ *
+ * @param configNameBuf config name to watch. If it ends with '*', all configs which start with
+ *                      the preceding string are watched. e.g. "com.webos.service.example.*"
+ * @param func pointer to callback function
+ * @param watch_context void pointer to userdata. The ownership is not transfered.
+ * @return true if watcher is added
+ */
+bool config_addKeyWatch(raw_buffer configNameBuf, configdNotify func, void *watch_context);
+
+/**
+ * Remove the watcher added by config_addKeyWatch()
+ *
+ * @param configNameBuf config name given to config_addKeyWatch()
+ * @param func pointer to function
+ * @return true if watcher is found and removed
+ */
+bool config_removeKeyWatch(raw_buffer configNameBuf, configdNotify func);
+
 /**
  * Return a duplicated array of requested config names.
  *
@@ -338,6 +388,56 @@ bool config_getStringDup(raw_buffer configNameBuf, raw_buffer *pData, int32_t *e
  */
 bool config_getJsonObject(raw_buffer configNameBuf, jvalue_ref *pData, int32_t *errorCode);
 
+/**
+ * Opaque handle of a config name. See config_getHandle()
+ */
+typedef struct ConfigHandle *config_handle_t;
+
+/**
+ * Resolve config name into handle.
+ *
+ * Getters with handle (config_get*ByHandle) skip hashing and comparing config name
+ * on every call. Resolve frequently used config names once and keep the handles.
+ *
+ * The same handle is returned for the same config name. The handle doesn't need to be
+ * freed and is valid until process exit, even if the config is changed or removed.
+ * The config doesn't need to exist when the handle is resolved.
+ *
+ * @param configNameBuf
+ * @param errorCode libconfigd_error_t will be returned if not null
+ * @return handle of configNameBuf, NULL if configNameBuf is not valid
+ *
+ * @example
+ *      static config_handle_t myFeatureHandle = NULL;
+ *      int32_t tmpEnabled = 0;
+ *      if (!myFeatureHandle)
+ *          myFeatureHandle = config_getHandle(J_CSTR_TO_BUF(CONFIGD_EXAMPLE_MY_FEATURE), NULL);
+ *      if (config_getBooleanByHandle(myFeatureHandle, &tmpEnabled, NULL)) {
+ *          isMyFeatureEnabled = tmpEnabled;
+ *      }
+ */
+config_handle_t config_getHandle(raw_buffer configNameBuf, int32_t *errorCode);
+
+/**
+ * Same as config_getBoolean() except config name is given by handle
+ */
+bool config_getBooleanByHandle(config_handle_t handle, int32_t *pData, int32_t *errorCode);
+
+/**
+ * Same as config_getInteger() except config name is given by handle
+ */
+bool config_getIntegerByHandle(config_handle_t handle, int32_t *pData, int32_t *errorCode);
+
+/**
+ * Same as config_getStringDup() except config name is given by handle
+ */
+bool config_getStringDupByHandle(config_handle_t handle, raw_buffer *pData, int32_t *errorCode);
+
+/**
+ * Same as config_getJsonObject() except config name is given by handle
+ */
+bool config_getJsonObjectByHandle(config_handle_t handle, jvalue_ref *pData, int32_t *errorCode);
+
 inline bool config_getBooleanSimple(raw_buffer configNameBuf, bool defaultValue)
 {
     bool retVal;
@@ -15,12 +15,15 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "JsonDB.h"
+#include "JsonDBJournal.h"
+#include "JsonDBSnapshot.h"
 
 #include <boost/regex.hpp>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <algorithm>
 #include "Environment.h"
+#include "util/Json.h"
 #include "util/Platform.h"
 #include "util/Logger.hpp"
 
@@ -42,6 +45,57 @@ const string JsonDB::FULLNAME_DEBUG_SETCONFIGS = JsonDB::CATEGORYNAME_CONFIGD +
 const string JsonDB::FULLNAME_DEBUG_PREPROCESS = JsonDB::CATEGORYNAME_CONFIGD + ".preprocess";
 const string JsonDB::FULLNAME_DEBUG_POSTPROCESS = JsonDB::CATEGORYNAME_CONFIGD + ".postprocess";
 
+bool JsonDB::s_isSnapshotEnabled = false;
+uint64_t JsonDB::s_generation = 0;
+
+/*
+ * Names which JsonDB::split can't resolve back into (categoryName, configName)
+ * are never reachable by fetch, so they are kept out of the index.
+ */
+static bool isIndexableName(const string &categoryName, const string &configName)
+{
+    if (categoryName.empty() || configName.empty() || configName == "*")
+        return false;
+    if (configName.find('.') != string::npos)
+        return false;
+    if (find_if(categoryName.begin(), categoryName.end(), ::isspace) != categoryName.end() ||
+        find_if(configName.begin(), configName.end(), ::isspace) != configName.end())
+        return false;
+    return true;
+}
+
+/*
+ * Literal prefix which every key matched by regEx starts with.
+ * It is empty if regEx is not anchored by '^' or can't be analyzed simply.
+ */
+static string getLiteralPrefix(const string &regEx)
+{
+    string prefix;
+
+    if (regEx.empty() || regEx[0] != '^' || regEx.find('|') != string::npos)
+        return prefix;
+
+    for (size_t i = 1; i < regEx.length(); ++i) {
+        char c = regEx[i];
+
+        // Escaped metacharacter. Other escapes such as \d or \< are not literal.
+        if (c == '\\' && i + 1 < regEx.length() && strchr(".[](){}*+?^$|\\/-", regEx[i + 1]) != NULL) {
+            prefix += regEx[++i];
+            continue;
+        }
+        if (strchr("\\.[](){}*+?^$", c) == NULL) {
+            prefix += c;
+            continue;
+        }
+
+        // Quantifier makes previous character optional
+        if ((c == '*' || c == '?' || c == '{') && !prefix.empty())
+            prefix.erase(prefix.length() - 1);
+        break;
+    }
+    return prefix;
+}
+
 bool JsonDB::split(const string &fullName, string &categoryName, string &configName)
 {
     string trimmedFullName = fullName;
@@ -91,17 +145,73 @@ bool JsonDB::getFullDBName(const string &categoryName, const JValue &category, J
     return true;
 }
 
+/*
+ * Collects full names which are added, changed or removed from oldDB to newDB
+ */
+void JsonDB::diff(JsonDB &oldDB, JsonDB &newDB, set<string> &changedNames)
+{
+    JValue &oldDatabase = oldDB.getDatabase();
+    JValue &newDatabase = newDB.getDatabase();
+
+    for (JValue::KeyValue category : newDatabase.children()) {
+        string categoryName = category.first.asString();
+        bool hasCategory = oldDatabase.hasKey(categoryName);
+
+        for (JValue::KeyValue config : category.second.children()) {
+            string configName = config.first.asString();
+            if (!hasCategory ||
+                !oldDatabase[categoryName].hasKey(configName) ||
+                oldDatabase[categoryName][configName] != config.second) {
+                changedNames.insert(categoryName + "." + configName);
+            }
+        }
+    }
+
+    for (JValue::KeyValue category : oldDatabase.children()) {
+        string categoryName = category.first.asString();
+        bool hasCategory = newDatabase.hasKey(categoryName);
+
+        for (JValue::KeyValue config : category.second.children()) {
+            string configName = config.first.asString();
+            if (!hasCategory || !newDatabase[categoryName].hasKey(configName)) {
+                changedNames.insert(categoryName + "." + configName);
+            }
+        }
+    }
+}
+
 JsonDB::JsonDB(string name)
     : m_name(name),
       m_filename(""),
-      m_isUpdated(false)
+      m_isUpdated(false),
+      m_generation(++s_generation),
+      m_isSnapshotEnabled(false),
+      m_isJournalEnabled(false),
+      m_isJournalValid(false)
 {
     m_database = pbnjson::Object();
 }
 
+void JsonDB::setPersistentSnapshotEnabled(bool enabled)
+{
+    s_isSnapshotEnabled = enabled;
+}
+
+void JsonDB::setSnapshotEnabled(bool enabled)
+{
+    m_isSnapshotEnabled = enabled;
+}
+
+void JsonDB::setJournalEnabled(bool enabled)
+{
+    m_isJournalEnabled = enabled;
+    m_journalRecords.clear();
+}
+
 JsonDB::~JsonDB()
 {
-    if (m_isUpdated) {
+    // In memory database is never synced
+    if (m_isUpdated && !m_filename.empty()) {
         Logger::warning(MSGID_CONFIGUREDATA,
                         LOG_PREPIX_FORMAT_EXT "Database is modified but not sync into file (%s)",
                         LOG_PREPIX_ARGS_EXT, m_name.c_str(), m_filename.c_str());
@@ -119,6 +229,9 @@ void JsonDB::copy(JsonDB& db)
 
     // Only database values are copied
     m_database = db.m_database.duplicate();
+    rebuildIndex();
+    invalidateJournal();
+    updateGeneration();
     m_isUpdated = true;
 }
 
@@ -156,6 +269,10 @@ bool JsonDB::insert(const string &categoryName, const string &configName, JValue
     if (!m_database[categoryName].put(configName, value))
         return false;
 
+    updateIndex(categoryName, configName, value);
+    if (m_isJournalEnabled && m_isJournalValid)
+        m_journalRecords += JsonDBJournal::createInsertRecord(categoryName, configName, value);
+    updateGeneration();
     m_isUpdated = true;
     return true;
 }
@@ -169,11 +286,16 @@ void JsonDB::load(const string &filename)
         return;
     }
 
-    JSchema schema = JSchema::fromFile(CONFIGFEATUESLIST_SCHEMA);
-    m_database = JDomParser::fromFile(filename.c_str(), schema);
-    if (m_database.isNull()) {
-        m_database = pbnjson::Object();
+    if (!loadSnapshot(filename)) {
+        const JSchema &schema = Json::getSchema(CONFIGFEATUESLIST_SCHEMA);
+        m_database = JDomParser::fromFile(filename.c_str(), schema);
+        if (m_database.isNull()) {
+            m_database = pbnjson::Object();
+        }
     }
+    rebuildIndex();
+    loadJournal(filename);
+    updateGeneration();
 
     if (!m_filename.empty() && m_filename != filename) {
         Logger::warning(MSGID_CONFIGUREDATA,
@@ -214,6 +336,11 @@ bool JsonDB::remove(const string &categoryName, const string &configName)
         return false;
     }
 
+    m_serializedValues.erase(categoryName + "." + configName);
+    m_sortedIndex.erase(categoryName + "." + configName);
+    if (m_isJournalEnabled && m_isJournalValid)
+        m_journalRecords += JsonDBJournal::createRemoveRecord(categoryName, configName);
+    updateGeneration();
     m_isUpdated = true;
     if (m_database[categoryName].objectSize() > 0) {
         return true;
@@ -247,7 +374,29 @@ void JsonDB::merge(JsonDB& jsonDB)
     merge(jsonDB.getDatabase());
 }
 
+void JsonDB::swap(JsonDB& jsonDB)
+{
+    // Only database values are swapped
+    JValue database = m_database;
+    m_database = jsonDB.m_database;
+    jsonDB.m_database = database;
+    m_serializedValues.swap(jsonDB.m_serializedValues);
+    m_sortedIndex.swap(jsonDB.m_sortedIndex);
+    invalidateJournal();
+    jsonDB.invalidateJournal();
+    updateGeneration();
+    jsonDB.updateGeneration();
+
+    m_isUpdated = true;
+    jsonDB.m_isUpdated = true;
+}
+
 bool JsonDB::fetch(const string &categoryName, const string &configName, JValue &result)
+{
+    return fetch(categoryName, configName, result, false);
+}
+
+bool JsonDB::fetch(const string &categoryName, const string &configName, JValue &result, bool isReference)
 {
     if (!m_database.hasKey(categoryName)) {
         Logger::debug(LOG_PREPIX_FORMAT "%s category does not exist",
@@ -260,7 +409,7 @@ bool JsonDB::fetch(const string &categoryName, const string &configName, JValue
     }
 
     if (configName == "*") {
-        return JsonDB::getFullDBName(categoryName, m_database[categoryName], result);
+        return fetchCategory(categoryName, result);
     }
 
     if (!m_database[categoryName].isValid() || !m_database[categoryName].hasKey(configName)) {
@@ -268,14 +417,60 @@ bool JsonDB::fetch(const string &categoryName, const string &configName, JValue
         return false;
     }
 
+    if (isReference)
+        return result.put(categoryName + "." + configName, m_database[categoryName][configName]);
     return result.put(categoryName + "." + configName, m_database[categoryName][configName].duplicate());
 }
 
+bool JsonDB::fetchCategory(const string &categoryName, JValue &result)
+{
+    string prefix = categoryName + ".";
+
+    // Like getFullDBName, but full names are already in m_sortedIndex
+    for (auto it = m_sortedIndex.lower_bound(prefix);
+         it != m_sortedIndex.end() && it->first.compare(0, prefix.length(), prefix) == 0; ++it) {
+        // Config of another category which starts with prefix (for example "category.sub")
+        if (it->second.categoryLength != categoryName.length())
+            continue;
+        if (!result.put(it->first, it->second.value))
+            return false;
+    }
+    return true;
+}
+
 bool JsonDB::fetch(const string &fullName, JValue &result)
+{
+    return fetch(fullName, result, false);
+}
+
+bool JsonDB::fetchReference(const string &fullName, JValue &result)
+{
+    return fetch(fullName, result, true);
+}
+
+bool JsonDB::fetch(const string &fullName, JValue &result, bool isReference)
 {
     string categoryName;
     string configName;
 
+    JValue *value = findExact(fullName);
+    if (value != NULL) {
+        if (result.isNull()) {
+            result = pbnjson::Object();
+        }
+        return result.put(fullName, isReference ? *value : value->duplicate());
+    }
+
+    // Only wildcard and untrimmed names need to be resolved through the nested database
+    bool isWildcard = (fullName.length() >= 2 && fullName.compare(fullName.length() - 2, 2, ".*") == 0);
+    bool hasSpace = (find_if(fullName.begin(), fullName.end(), ::isspace) != fullName.end());
+    if (!isWildcard && !hasSpace) {
+        Logger::debug(LOG_PREPIX_FORMAT "%s config does not exist in DB",
+                      LOG_PREPIX_ARGS,
+                      fullName.c_str());
+        return false;
+    }
+
     if (false == JsonDB::split(fullName, categoryName, configName)) {
         Logger::debug(LOG_PREPIX_FORMAT "Failed to get category/config name from \"%s\"",
                       LOG_PREPIX_ARGS,
@@ -290,7 +485,50 @@ bool JsonDB::fetch(const string &fullName, JValue &result)
         return false;
     }
 
-    return fetch(categoryName, configName, result);
+    return fetch(categoryName, configName, result, isReference);
+}
+
+string JsonDB::stringify(const JValue &payload)
+{
+    if (!payload.isObject() || !payload.hasKey("configs") || !payload["configs"].isObject())
+        return payload.stringify();
+
+    string text = "{";
+    for (JValue::KeyValue member : payload.children()) {
+        string key = member.first.asString();
+
+        if (text.length() > 1)
+            text += ",";
+        text += JValue(key).stringify() + ":";
+
+        if (key != "configs") {
+            text += member.second.stringify();
+            continue;
+        }
+
+        string configsText = "{";
+        for (JValue::KeyValue config : member.second.children()) {
+            string fullName = config.first.asString();
+
+            if (configsText.length() > 1)
+                configsText += ",";
+            configsText += JValue(fullName).stringify() + ":";
+
+            // Only values which are shared with database (see fetchReference) can be spliced
+            JValue *value = findExact(fullName);
+            if (value == NULL || value->peekRaw() != config.second.peekRaw()) {
+                configsText += config.second.stringify();
+                continue;
+            }
+
+            auto serialized = m_serializedValues.find(fullName);
+            if (serialized == m_serializedValues.end())
+                serialized = m_serializedValues.insert(make_pair(fullName, value->stringify())).first;
+            configsText += serialized->second;
+        }
+        text += configsText + "}";
+    }
+    return text + "}";
 }
 
 bool JsonDB::searchKey(const string &regEx, JValue &result)
@@ -302,21 +540,16 @@ bool returnValue = false;
 try
 {
     boost::regex name(regEx);
-    string categoryName;
-    string configName;
+    // Only keys which start with literal prefix of regEx are scanned
+    string prefix = getLiteralPrefix(regEx);
 
-    for (JValue::KeyValue category : m_database.children())
+    for (auto it = m_sortedIndex.lower_bound(prefix);
+         it != m_sortedIndex.end() && it->first.compare(0, prefix.length(), prefix) == 0; ++it)
     {
-        string categoryName = category.first.asString();
-        for (JValue::KeyValue config : category.second.children())
+        if (boost::regex_search(it->first, name))
         {
-            configName = config.first.asString();
-            string fullConfig = categoryName + "." + configName;
-            if (boost::regex_search(fullConfig, name))
-            {
-                result.put(fullConfig, m_database[categoryName][configName].duplicate());
-                returnValue = true;
-            }
+            result.put(it->first, it->second.value.duplicate());
+            returnValue = true;
         }
     }
 }
@@ -341,7 +574,15 @@ void JsonDB::clear()
     if (!Platform::deleteFile(m_filename.c_str())) {
         Logger::debug(LOG_PREPIX_FORMAT "Unable to delete file (%s)", LOG_PREPIX_ARGS, m_filename.c_str());
     }
+    if (!m_filename.empty()) {
+        Platform::deleteFile(JsonDBSnapshot::getFilename(m_filename));
+        Platform::deleteFile(JsonDBJournal::getFilename(m_filename));
+    }
     m_database = pbnjson::Object();
+    m_serializedValues.clear();
+    m_sortedIndex.clear();
+    invalidateJournal();
+    updateGeneration();
     m_isUpdated = true;
 }
 
@@ -353,6 +594,9 @@ bool JsonDB::flush()
     } else if (m_filename.empty()) {
         Logger::debug(LOG_PREPIX_FORMAT "In memory database", LOG_PREPIX_ARGS);
         return false;
+    } else if (flushJournal()) {
+        m_isUpdated = false;
+        return true;
     }
 
     string configData = m_database.stringify("    ");
@@ -398,6 +642,11 @@ bool JsonDB::flush()
         umask(mask);
         return false;
     }
+    flushSnapshot();
+    // New JSON file contains everything in journal
+    string journalFilename = JsonDBJournal::getFilename(m_filename);
+    m_journalRecords.clear();
+    m_isJournalValid = !Platform::isFileExist(journalFilename) || Platform::deleteFile(journalFilename);
     umask(mask);
     if (gerror != NULL) {
         g_error_free(gerror);
@@ -406,6 +655,151 @@ bool JsonDB::flush()
     return true;
 }
 
+bool JsonDB::loadSnapshot(const string &filename)
+{
+    if (!m_isSnapshotEnabled)
+        return false;
+
+    struct stat source;
+    if (stat(filename.c_str(), &source) != 0)
+        return false;
+
+    JValue database;
+    if (!JsonDBSnapshot::read(JsonDBSnapshot::getFilename(filename), source, database))
+        return false;
+
+    Logger::debug(LOG_PREPIX_FORMAT_EXT "Loaded from snapshot (%s)",
+                  LOG_PREPIX_ARGS_EXT, m_name.c_str(), filename.c_str());
+    m_database = database;
+    return true;
+}
+
+void JsonDB::flushSnapshot()
+{
+    if (!m_isSnapshotEnabled)
+        return;
+
+    // Stale snapshot is harmless (it is validated against JSON file), but useless
+    string snapshotFilename = JsonDBSnapshot::getFilename(m_filename);
+    struct stat source;
+    if (stat(m_filename.c_str(), &source) != 0 ||
+        !JsonDBSnapshot::write(snapshotFilename, m_database, source)) {
+        Platform::deleteFile(snapshotFilename);
+    }
+}
+
+void JsonDB::loadJournal(const string &filename)
+{
+    string journalFilename = JsonDBJournal::getFilename(filename);
+    struct stat source;
+    JValue records;
+    bool isComplete = true;
+
+    m_journalRecords.clear();
+    if (stat(filename.c_str(), &source) != 0) {
+        // Journal can't be appended without JSON file
+        m_isJournalValid = false;
+        return;
+    }
+    m_isJournalValid = true;
+    if (!Platform::isFileExist(journalFilename))
+        return;
+
+    if (!JsonDBJournal::read(journalFilename, source, records, isComplete)) {
+        // JSON file was rewritten after this journal
+        Platform::deleteFile(journalFilename);
+        return;
+    }
+
+    for (JValue record : records.items()) {
+        string operation = record[0].asString();
+        string categoryName = record[1].asString();
+        string configName = record[2].asString();
+
+        if (operation == JsonDBJournal::OPERATION_INSERT && record.arraySize() == 4) {
+            insert(categoryName, configName, record[3]);
+        } else if (operation == JsonDBJournal::OPERATION_REMOVE) {
+            remove(categoryName, configName);
+        }
+    }
+    Logger::debug(LOG_PREPIX_FORMAT_EXT "Replayed %d journal records (%s)",
+                  LOG_PREPIX_ARGS_EXT, m_name.c_str(), records.arraySize(), journalFilename.c_str());
+
+    // Replayed records are already in the journal file.
+    // Torn journal can't be appended anymore, so JSON file should be rewritten in next flush.
+    m_journalRecords.clear();
+    m_isJournalValid = isComplete;
+}
+
+bool JsonDB::flushJournal()
+{
+    if (!m_isJournalEnabled || !m_isJournalValid || m_journalRecords.empty())
+        return false;
+
+    string journalFilename = JsonDBJournal::getFilename(m_filename);
+    if (JsonDBJournal::getSize(journalFilename) + m_journalRecords.length() > JsonDBJournal::MAX_SIZE) {
+        Logger::debug(LOG_PREPIX_FORMAT_EXT "Compact journal (%s)",
+                      LOG_PREPIX_ARGS_EXT, m_name.c_str(), journalFilename.c_str());
+        return false;
+    }
+
+    struct stat source;
+    if (stat(m_filename.c_str(), &source) != 0 ||
+        !JsonDBJournal::append(journalFilename, source, m_journalRecords)) {
+        // Partially written records are dropped by rewriting JSON file and deleting journal
+        m_isJournalValid = false;
+        return false;
+    }
+    m_journalRecords.clear();
+    return true;
+}
+
+void JsonDB::invalidateJournal()
+{
+    // Next flush rewrites JSON file
+    m_isJournalValid = false;
+    m_journalRecords.clear();
+}
+
+void JsonDB::rebuildIndex()
+{
+    m_serializedValues.clear();
+    m_sortedIndex.clear();
+    if (!m_database.isObject())
+        return;
+
+    for (JValue::KeyValue category : m_database.children()) {
+        string categoryName = category.first.asString();
+        if (!category.second.isObject())
+            continue;
+
+        for (JValue::KeyValue config : category.second.children()) {
+            updateIndex(categoryName, config.first.asString(), config.second);
+        }
+    }
+}
+
+void JsonDB::updateIndex(const string &categoryName, const string &configName, JValue value)
+{
+    if (configName.empty())
+        return;
+
+    string fullName = categoryName + "." + configName;
+    IndexEntry &entry = m_sortedIndex[fullName];
+    entry.categoryLength = categoryName.length();
+    entry.isExact = isIndexableName(categoryName, configName);
+    entry.value = value;
+    m_serializedValues.erase(fullName);
+}
+
+JValue *JsonDB::findExact(const string &fullName)
+{
+    auto it = m_sortedIndex.find(fullName);
+    if (it == m_sortedIndex.end() || !it->second.isExact)
+        return NULL;
+    return &it->second.value;
+}
+
 JValue &JsonDB::getDatabase()
 {
     return m_database;
@@ -422,6 +816,7 @@ void JsonDB::setFilename(const string &filename)
         return;
     }
     m_filename = filename;
+    invalidateJournal();
     m_isUpdated = true;
 }
 
@@ -430,6 +825,16 @@ bool JsonDB::isUpdated()
     return m_isUpdated;
 }
 
+uint64_t JsonDB::getGeneration()
+{
+    return m_generation;
+}
+
+void JsonDB::updateGeneration()
+{
+    m_generation = ++s_generation;
+}
+
 bool JsonDB::isEqualDatabase(JsonDB& jsonDB)
 {
     return (jsonDB.getDatabase() == m_database);
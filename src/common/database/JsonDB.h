@@ -21,6 +21,10 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <map>
+#include <set>
+#include <unordered_map>
 
 #include <pbnjson.h>
 #include <pbnjson.hpp>
@@ -56,6 +60,7 @@ public:
     {
         static JsonDB _mainInstance("Main Database");
         if (_mainInstance.getFilename().empty()) {
+            _mainInstance.setSnapshotEnabled(s_isSnapshotEnabled);
             _mainInstance.load(FILENAME_MAIN_DB);
         }
         return _mainInstance;
@@ -77,6 +82,7 @@ public:
     {
         static JsonDB _factoryInstance("Factory Database");
         if (_factoryInstance.getFilename().empty()) {
+            _factoryInstance.setSnapshotEnabled(s_isSnapshotEnabled);
             _factoryInstance.load(FILENAME_FACTORY_DB);
         }
         return _factoryInstance;
@@ -86,6 +92,7 @@ public:
     {
         static JsonDB _permissionInstance("Permission Database");
         if (_permissionInstance.getFilename().empty()) {
+            _permissionInstance.setSnapshotEnabled(s_isSnapshotEnabled);
             _permissionInstance.load(FILENAME_PERMISSION_DB);
         }
         return _permissionInstance;
@@ -108,14 +115,23 @@ public:
 
     static bool split(const string &fullName, string &categoryName, string &configName);
     static bool getFullDBName(const string &categoryName, const JValue &category, JValue &result);
+    static void diff(JsonDB &oldDB, JsonDB &newDB, set<string> &changedNames);
 
     JsonDB(string name = "Unknown Database");
     virtual ~JsonDB();
 
+    // Binary snapshot (see JsonDBSnapshot) is written together with JSON file in flush to speed up load.
+    // Only main, factory and permission databases use it. Call before those are loaded.
+    static void setPersistentSnapshotEnabled(bool enabled);
+    void setSnapshotEnabled(bool enabled);
+    // Updates are appended to journal (see JsonDBJournal) instead of rewriting whole file in flush
+    void setJournalEnabled(bool enabled);
+
     void load(const string &filename);
     void copy(JsonDB& jsonDB);
     void merge(JValue& database);
     void merge(JsonDB& jsonDB);
+    void swap(JsonDB& jsonDB);
     void clear();
     bool flush();
 
@@ -125,22 +141,67 @@ public:
     bool remove(const string &categoryName, const string &configName);
     bool fetch(const string &categoryName, const string &configName, JValue &result);
     bool fetch(const string &fullName, JValue &result);
+    // Same as fetch, but values in result are shared with database. Those must not be modified.
+    bool fetchReference(const string &fullName, JValue &result);
     bool searchKey(const string &regEx, JValue &result);
 
+    // Serializes getConfigs payload. Values of this database in "configs" are spliced
+    // from cached text instead of being serialized again.
+    string stringify(const JValue &payload);
+
     JValue &getDatabase();
     string &getFilename();
     void setFilename(const string &filename);
     bool isUpdated();
+    // Changed whenever database values are changed. Unique among all JsonDB instances.
+    uint64_t getGeneration();
     bool isEqualDatabase(JsonDB& jsonDB);
     bool isEqualFilename(JsonDB& jsonDB);
     void printDebug();
 
 private:
+    static bool s_isSnapshotEnabled;
+    static uint64_t s_generation;
+
+    bool loadSnapshot(const string &filename);
+    void flushSnapshot();
+    void loadJournal(const string &filename);
+    bool flushJournal();
+    void invalidateJournal();
+    bool fetch(const string &categoryName, const string &configName, JValue &result, bool isReference);
+    bool fetch(const string &fullName, JValue &result, bool isReference);
+    bool fetchCategory(const string &categoryName, JValue &result);
+    void rebuildIndex();
+    void updateIndex(const string &categoryName, const string &configName, JValue value);
+    JValue *findExact(const string &fullName);
+    void updateGeneration();
+
     JValue m_database;
 
+    struct IndexEntry {
+        // Category names can have '.' too
+        size_t categoryLength;
+        // Full name is resolved to this value without splitting it. See isIndexableName.
+        bool isExact;
+        JValue value;
+    };
+
+    // All "category.config" names of m_database in sorted order for exact, wildcard and prefix queries.
+    // Values share storage with m_database, so they must be kept in sync on every update.
+    map<string, IndexEntry> m_sortedIndex;
+    // Serialized text of exactly indexed values. It is filled on demand.
+    unordered_map<string, string> m_serializedValues;
+
     string m_name;
     string m_filename;
     bool m_isUpdated;
+    uint64_t m_generation;
+    bool m_isSnapshotEnabled;
+
+    // Journal is valid only if file contents + journal + m_journalRecords == m_database
+    bool m_isJournalEnabled;
+    bool m_isJournalValid;
+    string m_journalRecords;
 
 };
 
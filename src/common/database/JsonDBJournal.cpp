@@ -0,0 +1,151 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "JsonDBJournal.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <glib.h>
+
+#include "util/Logger.hpp"
+
+const string JsonDBJournal::OPERATION_INSERT = "insert";
+const string JsonDBJournal::OPERATION_REMOVE = "remove";
+
+string JsonDBJournal::getFilename(const string &jsonFilename)
+{
+    return jsonFilename + ".journal";
+}
+
+size_t JsonDBJournal::getSize(const string &filename)
+{
+    struct stat journalStat;
+    if (stat(filename.c_str(), &journalStat) != 0)
+        return 0;
+    return journalStat.st_size;
+}
+
+string JsonDBJournal::createInsertRecord(const string &categoryName, const string &configName, const JValue &value)
+{
+    JValue record = pbnjson::Array();
+    record.append(OPERATION_INSERT);
+    record.append(categoryName);
+    record.append(configName);
+    record.append(value);
+    return record.stringify() + "\n";
+}
+
+string JsonDBJournal::createRemoveRecord(const string &categoryName, const string &configName)
+{
+    JValue record = pbnjson::Array();
+    record.append(OPERATION_REMOVE);
+    record.append(categoryName);
+    record.append(configName);
+    return record.stringify() + "\n";
+}
+
+JValue JsonDBJournal::createHeader(const struct stat &source)
+{
+    JValue header = pbnjson::Object();
+    header.put("inode", (int64_t)source.st_ino);
+    header.put("size", (int64_t)source.st_size);
+    header.put("mtimeSec", (int64_t)source.st_mtim.tv_sec);
+    header.put("mtimeNsec", (int64_t)source.st_mtim.tv_nsec);
+    return header;
+}
+
+bool JsonDBJournal::append(const string &filename, const struct stat &source, const string &records)
+{
+    string contents;
+    if (getSize(filename) == 0)
+        contents = createHeader(source).stringify() + "\n";
+    contents += records;
+
+    int fd = open(filename.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        Logger::error(MSGID_CONFIGUREDATA,
+                      LOG_PREPIX_FORMAT "Failed to open journal %s: %s",
+                      LOG_PREPIX_ARGS, filename.c_str(), g_strerror(errno));
+        return false;
+    }
+
+    const char *data = contents.c_str();
+    size_t remain = contents.length();
+    bool result = true;
+    while (remain > 0) {
+        ssize_t written = write(fd, data, remain);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0) {
+            result = false;
+            break;
+        }
+        data += written;
+        remain -= written;
+    }
+
+    // Only the appended records need to be durable, metadata is not important
+    if (result && fdatasync(fd) != 0)
+        result = false;
+    if (!result) {
+        Logger::error(MSGID_CONFIGUREDATA,
+                      LOG_PREPIX_FORMAT "Failed to write journal %s: %s",
+                      LOG_PREPIX_ARGS, filename.c_str(), g_strerror(errno));
+    }
+    close(fd);
+    return result;
+}
+
+bool JsonDBJournal::read(const string &filename, const struct stat &source, JValue &records, bool &isComplete)
+{
+    gchar *contents = NULL;
+    gsize length = 0;
+
+    isComplete = true;
+    if (!g_file_get_contents(filename.c_str(), &contents, &length, NULL))
+        return false;
+
+    string data(contents, length);
+    g_free(contents);
+
+    size_t begin = 0;
+    size_t end = data.find('\n');
+    if (end == string::npos || JDomParser::fromString(data.substr(0, end)) != createHeader(source)) {
+        Logger::debug(LOG_PREPIX_FORMAT "Journal is stale (%s)", LOG_PREPIX_ARGS, filename.c_str());
+        return false;
+    }
+
+    records = pbnjson::Array();
+    for (begin = end + 1; begin < data.length(); begin = end + 1) {
+        end = data.find('\n', begin);
+        JValue record;
+        if (end != string::npos)
+            record = JDomParser::fromString(data.substr(begin, end - begin));
+
+        // Tail could be torn by sudden power off. Records after that are not trusted.
+        if (!record.isArray() || record.arraySize() < 3) {
+            Logger::warning(MSGID_CONFIGUREDATA,
+                            LOG_PREPIX_FORMAT "Journal is truncated (%s)",
+                            LOG_PREPIX_ARGS, filename.c_str());
+            isComplete = false;
+            break;
+        }
+        records.append(record);
+    }
+    return true;
+}
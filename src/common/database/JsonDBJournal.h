@@ -0,0 +1,65 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _JSONDB_JOURNAL_H_
+#define _JSONDB_JOURNAL_H_
+
+#include <iostream>
+#include <sys/stat.h>
+
+#include <pbnjson.hpp>
+
+using namespace std;
+using namespace pbnjson;
+
+/*
+ * Append-only journal of JsonDB updates.
+ *
+ * Small updates are appended to the journal instead of rewriting the whole
+ * JSON file. The first line identifies the JSON file (inode, size, mtime)
+ * which the journal applies to, so a journal left behind by a rewritten JSON
+ * file is never replayed on top of it.
+ *
+ * Layout (one JSON value per line)
+ *   {"inode":..., "size":..., "mtimeSec":..., "mtimeNsec":...}
+ *   ["insert", "categoryName", "configName", value]
+ *   ["remove", "categoryName", "configName"]
+ */
+class JsonDBJournal {
+public:
+    // JSON file is rewritten (compacted) once the journal grows beyond this size
+    static const size_t MAX_SIZE = 64 * 1024;
+
+    static const string OPERATION_INSERT;
+    static const string OPERATION_REMOVE;
+
+    static string getFilename(const string &jsonFilename);
+    static size_t getSize(const string &filename);
+
+    static string createInsertRecord(const string &categoryName, const string &configName, const JValue &value);
+    static string createRemoveRecord(const string &categoryName, const string &configName);
+
+    static bool append(const string &filename, const struct stat &source, const string &records);
+    static bool read(const string &filename, const struct stat &source, JValue &records, bool &isComplete);
+
+private:
+    static JValue createHeader(const struct stat &source);
+
+    JsonDBJournal() {};
+    virtual ~JsonDBJournal() {};
+};
+
+#endif // _JSONDB_JOURNAL_H_
@@ -0,0 +1,377 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "JsonDBSnapshot.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+#include <sys/mman.h>
+#include <glib.h>
+
+#include "util/Logger.hpp"
+
+static const int SNAPSHOT_MAX_DEPTH = 128;
+
+const string JsonDBSnapshot::FILENAME_SHARED = SNAPSHOT_SHARED_PATH;
+
+string JsonDBSnapshot::getFilename(const string &jsonFilename)
+{
+    return jsonFilename + ".snapshot";
+}
+
+uint32_t JsonDBSnapshot::Writer::addString(const string &str)
+{
+    auto it = m_stringOffsets.find(str);
+    if (it != m_stringOffsets.end())
+        return it->second;
+
+    uint32_t offset = m_strings.length();
+    m_strings.append(str);
+    m_stringOffsets[str] = offset;
+    return offset;
+}
+
+void JsonDBSnapshot::Writer::putUint32(uint32_t value)
+{
+    m_values.append((const char*)&value, sizeof(value));
+}
+
+void JsonDBSnapshot::Writer::putString(const string &str)
+{
+    putUint32(addString(str));
+    putUint32(str.length());
+}
+
+void JsonDBSnapshot::Writer::encode(const JValue &value)
+{
+    if (value.isNull()) {
+        m_values.push_back(ValueTag_Null);
+    } else if (value.isBoolean()) {
+        m_values.push_back(value.asBool() ? ValueTag_True : ValueTag_False);
+    } else if (value.isNumber()) {
+        int64_t integer = 0;
+        double number = 0;
+        if (value.asNumber<int64_t>(integer) == CONV_OK) {
+            m_values.push_back(ValueTag_Integer);
+            m_values.append((const char*)&integer, sizeof(integer));
+        } else if (value.asNumber<double>(number) == CONV_OK) {
+            m_values.push_back(ValueTag_Double);
+            m_values.append((const char*)&number, sizeof(number));
+        } else {
+            // Keep numbers which don't fit into int64/double in their textual form
+            m_values.push_back(ValueTag_RawNumber);
+            putString(value.stringify());
+        }
+    } else if (value.isString()) {
+        m_values.push_back(ValueTag_String);
+        putString(value.asString());
+    } else if (value.isArray()) {
+        m_values.push_back(ValueTag_Array);
+        putUint32(value.arraySize());
+        for (JValue item : value.items()) {
+            encode(item);
+        }
+    } else if (value.isObject()) {
+        m_values.push_back(ValueTag_Object);
+        putUint32(value.objectSize());
+        for (JValue::KeyValue child : value.children()) {
+            putString(child.first.asString());
+            encode(child.second);
+        }
+    } else {
+        m_values.push_back(ValueTag_Null);
+    }
+}
+
+JsonDBSnapshot::Reader::Reader(const char *strings, uint32_t stringsSize, const char *values, uint32_t valuesSize)
+    : m_strings(strings),
+      m_stringsSize(stringsSize),
+      m_values(values),
+      m_valuesSize(valuesSize)
+{
+}
+
+bool JsonDBSnapshot::Reader::getString(uint32_t offset, uint32_t length, string &str)
+{
+    if (offset > m_stringsSize || length > m_stringsSize - offset)
+        return false;
+    str.assign(m_strings + offset, length);
+    return true;
+}
+
+bool JsonDBSnapshot::Reader::getUint32(uint32_t &offset, uint32_t &value)
+{
+    if (offset > m_valuesSize || sizeof(value) > m_valuesSize - offset)
+        return false;
+    memcpy(&value, m_values + offset, sizeof(value));
+    offset += sizeof(value);
+    return true;
+}
+
+bool JsonDBSnapshot::Reader::decode(uint32_t &offset, JValue &value, int depth)
+{
+    if (depth > SNAPSHOT_MAX_DEPTH || offset >= m_valuesSize)
+        return false;
+
+    uint8_t tag = m_values[offset++];
+    uint32_t stringOffset = 0, stringLength = 0, count = 0;
+    string str;
+
+    switch (tag) {
+    case ValueTag_Null:
+        value = JValue();
+        return true;
+
+    case ValueTag_False:
+    case ValueTag_True:
+        value = JValue(tag == ValueTag_True);
+        return true;
+
+    case ValueTag_Integer: {
+        int64_t integer = 0;
+        if (sizeof(integer) > m_valuesSize - offset)
+            return false;
+        memcpy(&integer, m_values + offset, sizeof(integer));
+        offset += sizeof(integer);
+        value = JValue(integer);
+        return true;
+    }
+
+    case ValueTag_Double: {
+        double number = 0;
+        if (sizeof(number) > m_valuesSize - offset)
+            return false;
+        memcpy(&number, m_values + offset, sizeof(number));
+        offset += sizeof(number);
+        value = JValue(number);
+        return true;
+    }
+
+    case ValueTag_RawNumber:
+    case ValueTag_String:
+        if (!getUint32(offset, stringOffset) || !getUint32(offset, stringLength))
+            return false;
+        if (!getString(stringOffset, stringLength, str))
+            return false;
+        if (tag == ValueTag_String)
+            value = JValue(str);
+        else
+            value = JDomParser::fromString(str);
+        return value.isValid();
+
+    case ValueTag_Array:
+        if (!getUint32(offset, count))
+            return false;
+        value = pbnjson::Array();
+        for (uint32_t i = 0; i < count; i++) {
+            JValue item;
+            if (!decode(offset, item, depth + 1))
+                return false;
+            value.append(item);
+        }
+        return true;
+
+    case ValueTag_Object:
+        if (!getUint32(offset, count))
+            return false;
+        value = pbnjson::Object();
+        for (uint32_t i = 0; i < count; i++) {
+            JValue child;
+            if (!getUint32(offset, stringOffset) || !getUint32(offset, stringLength))
+                return false;
+            if (!getString(stringOffset, stringLength, str))
+                return false;
+            if (!decode(offset, child, depth + 1))
+                return false;
+            value.put(str, child);
+        }
+        return true;
+
+    default:
+        break;
+    }
+    return false;
+}
+
+bool JsonDBSnapshot::isSameSource(const Header &header, const struct stat &source)
+{
+    return header.sourceInode == (uint64_t)source.st_ino &&
+           header.sourceSize == (uint64_t)source.st_size &&
+           header.sourceMtimeSec == (int64_t)source.st_mtim.tv_sec &&
+           header.sourceMtimeNsec == (int64_t)source.st_mtim.tv_nsec;
+}
+
+bool JsonDBSnapshot::write(const string &filename, const JValue &database, const struct stat &source)
+{
+    return write(filename, database, source, 0, false);
+}
+
+bool JsonDBSnapshot::publish(const string &filename, const JValue &database, uint64_t generation)
+{
+    struct stat source;
+    memset(&source, 0, sizeof(source));
+
+    // Image is replaced by rename, so clients which mapped old image keep reading consistent data
+    return write(filename, database, source, generation, true);
+}
+
+bool JsonDBSnapshot::write(const string &filename, const JValue &database, const struct stat &source,
+                           uint64_t generation, bool isSorted)
+{
+    if (filename.empty() || !database.isObject())
+        return false;
+
+    Writer writer;
+    vector<pair<string, Entry>> entries;
+
+    for (JValue::KeyValue category : database.children()) {
+        string categoryName = category.first.asString();
+        if (!category.second.isObject())
+            continue;
+
+        for (JValue::KeyValue config : category.second.children()) {
+            string configName = config.first.asString();
+            Entry entry;
+
+            entry.categoryOffset = writer.addString(categoryName);
+            entry.categoryLength = categoryName.length();
+            entry.configOffset = writer.addString(configName);
+            entry.configLength = configName.length();
+            entry.valueOffset = writer.m_values.length();
+            writer.encode(config.second);
+            entries.push_back(make_pair(categoryName + "." + configName, entry));
+        }
+    }
+    // Only shared image is searched by name (libconfigd). Snapshot of JSON file is always read as a whole.
+    if (isSorted)
+        sort(entries.begin(), entries.end(),
+             [](const pair<string, Entry> &a, const pair<string, Entry> &b) { return a.first < b.first; });
+
+    Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.generation = generation;
+    header.sourceInode = source.st_ino;
+    header.sourceSize = source.st_size;
+    header.sourceMtimeSec = source.st_mtim.tv_sec;
+    header.sourceMtimeNsec = source.st_mtim.tv_nsec;
+    header.stringTableOffset = sizeof(Header);
+    header.stringTableSize = writer.m_strings.length();
+    header.indexOffset = header.stringTableOffset + header.stringTableSize;
+    header.entryCount = entries.size();
+    header.valueOffset = header.indexOffset + header.entryCount * sizeof(Entry);
+    header.valueSize = writer.m_values.length();
+
+    string image;
+    image.reserve(header.valueOffset + header.valueSize);
+    image.append((const char*)&header, sizeof(header));
+    image.append(writer.m_strings);
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        image.append((const char*)&it->second, sizeof(Entry));
+    }
+    image.append(writer.m_values);
+
+    GError *gerror = NULL;
+    if (!g_file_set_contents(filename.c_str(), image.c_str(), image.length(), &gerror)) {
+        Logger::warning(MSGID_CONFIGUREDATA,
+                        LOG_PREPIX_FORMAT "Failed to write snapshot %s: %s",
+                        LOG_PREPIX_ARGS, filename.c_str(), gerror ? gerror->message : "unknown");
+        if (gerror != NULL)
+            g_error_free(gerror);
+        return false;
+    }
+    return true;
+}
+
+bool JsonDBSnapshot::read(const string &filename, const struct stat &source, JValue &database)
+{
+    int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    struct stat snapshotStat;
+    if (fstat(fd, &snapshotStat) != 0 || (size_t)snapshotStat.st_size < sizeof(Header)) {
+        close(fd);
+        return false;
+    }
+
+    size_t size = snapshotStat.st_size;
+    void *addr = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        Logger::warning(MSGID_CONFIGUREDATA,
+                        LOG_PREPIX_FORMAT "Failed to mmap snapshot %s",
+                        LOG_PREPIX_ARGS, filename.c_str());
+        return false;
+    }
+
+    const char *base = (const char*)addr;
+    Header header;
+    memcpy(&header, base, sizeof(header));
+
+    bool result = false;
+    JValue loaded = pbnjson::Object();
+
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 || header.version != VERSION) {
+        Logger::debug(LOG_PREPIX_FORMAT "Unknown snapshot format (%s)", LOG_PREPIX_ARGS, filename.c_str());
+    } else if (!isSameSource(header, source)) {
+        Logger::debug(LOG_PREPIX_FORMAT "Snapshot is stale (%s)", LOG_PREPIX_ARGS, filename.c_str());
+    } else if ((uint64_t)header.stringTableOffset + header.stringTableSize > size ||
+               (uint64_t)header.indexOffset + (uint64_t)header.entryCount * sizeof(Entry) > size ||
+               (uint64_t)header.valueOffset + header.valueSize > size) {
+        Logger::warning(MSGID_CONFIGUREDATA,
+                        LOG_PREPIX_FORMAT "Snapshot is truncated (%s)",
+                        LOG_PREPIX_ARGS, filename.c_str());
+    } else {
+        Reader reader(base + header.stringTableOffset, header.stringTableSize,
+                      base + header.valueOffset, header.valueSize);
+        result = true;
+
+        for (uint32_t i = 0; i < header.entryCount; i++) {
+            Entry entry;
+            string categoryName, configName;
+            JValue value;
+
+            memcpy(&entry, base + header.indexOffset + i * sizeof(Entry), sizeof(Entry));
+            uint32_t valueOffset = entry.valueOffset;
+            if (!reader.getString(entry.categoryOffset, entry.categoryLength, categoryName) ||
+                !reader.getString(entry.configOffset, entry.configLength, configName) ||
+                !reader.decode(valueOffset, value)) {
+                Logger::warning(MSGID_CONFIGUREDATA,
+                                LOG_PREPIX_FORMAT "Snapshot is corrupted (%s)",
+                                LOG_PREPIX_ARGS, filename.c_str());
+                result = false;
+                break;
+            }
+
+            if (!loaded.hasKey(categoryName))
+                loaded.put(categoryName, pbnjson::Object());
+            loaded[categoryName].put(configName, value);
+        }
+    }
+
+    if (munmap(addr, size) != 0) {
+        Logger::warning(MSGID_CONFIGUREDATA, LOG_PREPIX_FORMAT "Error in munmap", LOG_PREPIX_ARGS);
+    }
+
+    if (result)
+        database = loaded;
+    return result;
+}
@@ -0,0 +1,109 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _JSONDB_SNAPSHOT_H_
+#define _JSONDB_SNAPSHOT_H_
+
+#include <iostream>
+#include <map>
+#include <stdint.h>
+#include <sys/stat.h>
+
+#include <pbnjson.hpp>
+
+#include "SnapshotFormat.h"
+
+using namespace std;
+using namespace pbnjson;
+
+/*
+ * Compact binary image of a JsonDB file (see SnapshotFormat.h).
+ *
+ * The snapshot is written next to the JSON file whenever it is flushed and
+ * remembers the identity (inode, size, mtime) of that JSON file. It is only
+ * used while the JSON file is unchanged, so JSON stays the source of truth
+ * and the export/debug format.
+ *
+ * The same image of the unified database is published for libconfigd
+ * clients (publish). It has no source JSON file, but a generation instead.
+ */
+class JsonDBSnapshot {
+public:
+    static const uint32_t VERSION = SNAPSHOT_VERSION;
+    static const string FILENAME_SHARED;
+
+    static string getFilename(const string &jsonFilename);
+
+    static bool write(const string &filename, const JValue &database, const struct stat &source);
+    static bool read(const string &filename, const struct stat &source, JValue &database);
+    static bool publish(const string &filename, const JValue &database, uint64_t generation);
+
+private:
+    typedef SnapshotHeader Header;
+    typedef SnapshotEntry Entry;
+
+    enum ValueTag {
+        ValueTag_Null = SnapshotValueTag_Null,
+        ValueTag_False = SnapshotValueTag_False,
+        ValueTag_True = SnapshotValueTag_True,
+        ValueTag_Integer = SnapshotValueTag_Integer,
+        ValueTag_Double = SnapshotValueTag_Double,
+        ValueTag_RawNumber = SnapshotValueTag_RawNumber,
+        ValueTag_String = SnapshotValueTag_String,
+        ValueTag_Array = SnapshotValueTag_Array,
+        ValueTag_Object = SnapshotValueTag_Object
+    };
+
+    class Writer {
+    public:
+        uint32_t addString(const string &str);
+        void encode(const JValue &value);
+
+        string m_strings;
+        string m_values;
+
+    private:
+        void putString(const string &str);
+        void putUint32(uint32_t value);
+
+        map<string, uint32_t> m_stringOffsets;
+    };
+
+    class Reader {
+    public:
+        Reader(const char *strings, uint32_t stringsSize, const char *values, uint32_t valuesSize);
+
+        bool getString(uint32_t offset, uint32_t length, string &str);
+        bool decode(uint32_t &offset, JValue &value, int depth = 0);
+
+    private:
+        bool getUint32(uint32_t &offset, uint32_t &value);
+
+        const char *m_strings;
+        uint32_t m_stringsSize;
+        const char *m_values;
+        uint32_t m_valuesSize;
+    };
+
+    static bool isSameSource(const Header &header, const struct stat &source);
+    static bool write(const string &filename, const JValue &database, const struct stat &source,
+                      uint64_t generation, bool isSorted);
+
+    JsonDBSnapshot() {};
+    virtual ~JsonDBSnapshot() {};
+};
+
+#endif // _JSONDB_SNAPSHOT_H_
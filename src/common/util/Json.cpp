@@ -17,6 +17,27 @@
 #include "Json.h"
 #include "Logger.hpp"
 
+map<string, JSchema> Json::s_schemas;
+
+const JSchema& Json::getSchema(const string &filename)
+{
+    auto it = s_schemas.find(filename);
+    if (it != s_schemas.end())
+        return it->second;
+
+    JSchema schema = JSchema::fromFile(filename.c_str());
+    if (!schema.isInitialized()) {
+        Logger::warning(MSGID_JSON_PARSE_FILE_ERR,
+                        LOG_PREPIX_FORMAT "Failed to load schema %s",
+                        LOG_PREPIX_ARGS, filename.c_str());
+        // Not cached, so that it is loaded again if the file is fixed
+        static JSchema failedSchema = schema;
+        failedSchema = schema;
+        return failedSchema;
+    }
+    return s_schemas.insert(make_pair(filename, schema)).first->second;
+}
+
 void Json::addUniqueStrIntoArray(JValue array, string uniqueStr)
 {
     if (!array.isArray() || uniqueStr.empty())
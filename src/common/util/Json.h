@@ -18,6 +18,7 @@
 #define UTIL_JSON_H_
 
 #include <iostream>
+#include <map>
 
 #include <pbnjson.h>
 #include <pbnjson.hpp>
@@ -31,7 +32,12 @@ public:
     static bool getValueWithKeys(JValue root, JValue array, JValue &value);
     static void printDiffValue(JValue a, JValue b);
 
+    // Schema files are compiled once and shared by all callers. Failed ones are loaded again.
+    static const JSchema& getSchema(const string &filename);
+
 private:
+    static map<string, JSchema> s_schemas;
+
     Json() {};
     virtual ~Json() {};
 };
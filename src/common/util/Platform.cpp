@@ -46,7 +46,8 @@ bool Platform::isDirExist(const string &path)
 bool Platform::canWriteFile(const string &path)
 {
     FILE *fp = NULL;
-    if(!(fp = fopen(path.c_str(), "w+"))) {
+    // Append mode doesn't truncate existing file
+    if(!(fp = fopen(path.c_str(), "a"))) {
         return false;
     }
 
@@ -108,31 +109,28 @@ bool Platform::deleteFile(const string &filename)
 
 string Platform::executeCommand(const string &command, const string firstArg, const string secondArg)
 {
-    string console = "";
-    string newCommand = command + " " + firstArg + " " + secondArg;
+    ProcessExecutor executor;
+    vector<string> args;
 
-    executeCommand(newCommand, console);
-    return console;
+    args.push_back(firstArg);
+    args.push_back(secondArg);
+    if (!executor.start(command, args) || !executor.wait())
+        return "";
+
+    boost::trim(executor.getOutput());
+    return executor.getOutput();
 }
 
-bool Platform::executeCommand(const string &command, string &console)
+bool Platform::executeCommand(const string &command, string &console, int timeout)
 {
-    FILE *file;
-    char buff[256];
+    ProcessExecutor executor;
 
-    if (!(file = popen(command.c_str(), "r"))){
+    console.clear();
+    if (!executor.start(command, vector<string>(), timeout) || !executor.wait())
         return false;
-    }
 
-    console.clear();
-    Logger::info(MSGID_CONFIGDSERVICE,
-                 LOG_PREPIX_FORMAT "Execute command (%s)",
-                 LOG_PREPIX_ARGS, command.c_str());
-    while(fgets(buff, sizeof(buff), file)!=NULL){
-        console += buff;
-    }
+    console = executor.getOutput();
     boost::trim(console);
-    pclose(file);
     return true;
 }
 
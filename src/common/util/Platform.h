@@ -22,6 +22,7 @@
 #include <glib.h>
 
 #include "Environment.h"
+#include "util/ProcessExecutor.h"
 
 using namespace std;
 
@@ -35,8 +36,10 @@ public:
     static bool copyFile(const string &from, const string &to);
     static bool deleteFile(const string &dbFileName);
 
+    // Commands are killed after the timeout (ProcessExecutor::MS_DEFAULT_TIMEOUT, 60 seconds by default).
+    // Output of timed out command is discarded, so empty string or false is returned.
     static string executeCommand(const string &command, const string firstArg, const string secondArg);
-    static bool executeCommand(const string &command, string &console);
+    static bool executeCommand(const string &command, string &console, int timeout = ProcessExecutor::MS_DEFAULT_TIMEOUT);
 
     static string concatPaths(string parent, string child);
     static void extractFileName(string &fileName, string &name, string &extension);
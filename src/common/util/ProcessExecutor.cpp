@@ -0,0 +1,390 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "Logging.h"
+#include "util/Logger.hpp"
+#include "util/ProcessExecutor.h"
+
+extern char **environ;
+
+// Commands with these characters need /bin/sh
+static const char *SHELL_CHARACTERS = "|&;<>()$`*?[]{}~#\n";
+// Polling interval for processes which closed stdout but not exited yet
+static const int MS_REAP_INTERVAL = 10;
+
+void ProcessExecutor::waitAll(const vector<ProcessExecutor*> &executors)
+{
+    while (true) {
+        vector<struct pollfd> fds;
+        // Executor and whether the fd is its stdin (true) or stdout (false)
+        vector<pair<ProcessExecutor*, bool>> handlers;
+        gint64 now = g_get_monotonic_time();
+        gint64 deadline = INT64_MAX;
+        bool isReaping = false;
+
+        for (ProcessExecutor *executor : executors) {
+            if (!executor->isRunning())
+                continue;
+            if (now >= executor->m_deadline) {
+                executor->expire();
+                continue;
+            }
+            if (executor->m_output < 0 && executor->reap(false))
+                continue;
+
+            deadline = min(deadline, executor->m_deadline);
+            if (executor->m_input >= 0) {
+                struct pollfd fd = { executor->m_input, POLLOUT, 0 };
+                fds.push_back(fd);
+                handlers.push_back(make_pair(executor, true));
+            }
+            if (executor->m_output < 0) {
+                isReaping = true;
+                continue;
+            }
+            struct pollfd fd = { executor->m_output, POLLIN, 0 };
+            fds.push_back(fd);
+            handlers.push_back(make_pair(executor, false));
+        }
+        if (deadline == INT64_MAX)
+            break;
+
+        int timeout = (deadline - now) / 1000 + 1;
+        if (isReaping)
+            timeout = min(timeout, MS_REAP_INTERVAL);
+        if (poll(fds.data(), fds.size(), timeout) <= 0)
+            continue;
+
+        for (size_t i = 0; i < fds.size(); ++i) {
+            if (fds[i].revents == 0)
+                continue;
+            if (handlers[i].second)
+                handlers[i].first->writeInput();
+            else
+                handlers[i].first->readOutput();
+        }
+    }
+}
+
+ProcessExecutor::ProcessExecutor()
+    : m_pid(0),
+      m_output(-1),
+      m_input(-1),
+      m_deadline(0),
+      m_isTimeout(false),
+      m_exitStatus(-1),
+      m_inputOffset(0),
+      m_hasInput(false),
+      m_isDirect(false)
+{
+}
+
+ProcessExecutor::~ProcessExecutor()
+{
+    if (isRunning())
+        kill();
+    if (m_output >= 0)
+        close(m_output);
+    closeInput();
+}
+
+void ProcessExecutor::parseCommand(const string &command, const vector<string> &args, bool isDirect, vector<string> &argv)
+{
+    argv.clear();
+    if (isDirect && command.find_first_of(SHELL_CHARACTERS) == string::npos) {
+        gint argc = 0;
+        gchar **parsed = NULL;
+
+        // Environment assignment such as "A=1 command" needs shell too
+        if (g_shell_parse_argv(command.c_str(), &argc, &parsed, NULL) && strchr(parsed[0], '=') == NULL) {
+            for (gint i = 0; i < argc; ++i)
+                argv.push_back(parsed[i]);
+            for (const string &arg : args) {
+                if (!arg.empty())
+                    argv.push_back(arg);
+            }
+        }
+        g_strfreev(parsed);
+        if (!argv.empty())
+            return;
+    }
+
+    string shellCommand = command;
+    for (const string &arg : args)
+        shellCommand += " " + arg;
+    argv.push_back("/bin/sh");
+    argv.push_back("-c");
+    argv.push_back(shellCommand);
+}
+
+void ProcessExecutor::setInput(const string &input)
+{
+    m_inputData = input;
+    m_hasInput = true;
+}
+
+void ProcessExecutor::setDirect(bool isDirect)
+{
+    m_isDirect = isDirect;
+}
+
+bool ProcessExecutor::start(const string &command, const vector<string> &args, int timeout)
+{
+    vector<string> argv;
+    vector<char*> spawnArgv;
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    sigset_t mask;
+    int pipefd[2];
+    int inputfd[2] = { -1, -1 };
+
+    if (isRunning()) {
+        Logger::warning(MSGID_CONFIGDSERVICE,
+                        LOG_PREPIX_FORMAT "Process is already running (%s)",
+                        LOG_PREPIX_ARGS, command.c_str());
+        return false;
+    }
+
+    parseCommand(command, args, m_isDirect, argv);
+    for (string &arg : argv)
+        spawnArgv.push_back(const_cast<char*>(arg.c_str()));
+    spawnArgv.push_back(NULL);
+
+    if (pipe2(pipefd, O_CLOEXEC) != 0) {
+        Logger::warning(MSGID_CONFIGDSERVICE,
+                        LOG_PREPIX_FORMAT "Failed to create pipe (%s)",
+                        LOG_PREPIX_ARGS, strerror(errno));
+        return false;
+    }
+
+    if (m_hasInput && pipe2(inputfd, O_CLOEXEC) != 0) {
+        Logger::warning(MSGID_CONFIGDSERVICE,
+                        LOG_PREPIX_FORMAT "Failed to create pipe (%s)",
+                        LOG_PREPIX_ARGS, strerror(errno));
+        close(pipefd[0]);
+        close(pipefd[1]);
+        return false;
+    }
+    // Child gets its own process group, so that all of its children are killed in timeout
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, pipefd[1], STDOUT_FILENO);
+    if (m_hasInput)
+        posix_spawn_file_actions_adddup2(&actions, inputfd[0], STDIN_FILENO);
+    posix_spawnattr_init(&attr);
+    sigemptyset(&mask);
+    posix_spawnattr_setsigmask(&attr, &mask);
+    sigaddset(&mask, SIGPIPE);
+    posix_spawnattr_setsigdefault(&attr, &mask);
+    posix_spawnattr_setpgroup(&attr, 0);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+    int error = posix_spawnp(&m_pid, spawnArgv[0], &actions, &attr, spawnArgv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+    close(pipefd[1]);
+    if (m_hasInput)
+        close(inputfd[0]);
+
+    if (error != 0) {
+        Logger::warning(MSGID_CONFIGDSERVICE,
+                        LOG_PREPIX_FORMAT "Failed to spawn (%s) : %s",
+                        LOG_PREPIX_ARGS, command.c_str(), strerror(error));
+        close(pipefd[0]);
+        if (m_hasInput)
+            close(inputfd[1]);
+        m_pid = 0;
+        return false;
+    }
+    Logger::info(MSGID_CONFIGDSERVICE,
+                 LOG_PREPIX_FORMAT "Execute command (%s%s)",
+                 LOG_PREPIX_ARGS, command.c_str(), argv[0] == "/bin/sh" ? ", shell" : "");
+
+    m_output = pipefd[0];
+    fcntl(m_output, F_SETFL, fcntl(m_output, F_GETFL) | O_NONBLOCK);
+    if (m_hasInput) {
+        m_input = inputfd[1];
+        m_inputOffset = 0;
+        fcntl(m_input, F_SETFL, fcntl(m_input, F_GETFL) | O_NONBLOCK);
+    }
+    m_deadline = g_get_monotonic_time() + (gint64) timeout * 1000;
+    m_isTimeout = false;
+    m_exitStatus = -1;
+    m_console.clear();
+    return true;
+}
+
+bool ProcessExecutor::wait()
+{
+    waitAll(vector<ProcessExecutor*>(1, this));
+    return !m_isTimeout;
+}
+
+void ProcessExecutor::expire()
+{
+    if (!isRunning())
+        return;
+
+    Logger::warning(MSGID_CONFIGDSERVICE,
+                    LOG_PREPIX_FORMAT "Process (%d) is timed out",
+                    LOG_PREPIX_ARGS, m_pid);
+    kill();
+    m_isTimeout = true;
+}
+
+int ProcessExecutor::getOutputFd()
+{
+    return m_output;
+}
+
+bool ProcessExecutor::isRunning()
+{
+    return m_pid > 0;
+}
+
+bool ProcessExecutor::isTimeout()
+{
+    return m_isTimeout;
+}
+
+int ProcessExecutor::getExitStatus()
+{
+    return m_exitStatus;
+}
+
+string &ProcessExecutor::getOutput()
+{
+    return m_console;
+}
+
+bool ProcessExecutor::readOutput()
+{
+    char buffer[4096];
+
+    if (m_output < 0)
+        return false;
+
+    while (true) {
+        ssize_t length = read(m_output, buffer, sizeof(buffer));
+        if (length > 0) {
+            m_console.append(buffer, length);
+            continue;
+        }
+        if (length < 0 && (errno == EAGAIN || errno == EINTR))
+            return true;
+
+        // EOF or error. Process is reaped when it exits.
+        close(m_output);
+        m_output = -1;
+        reap(false);
+        return false;
+    }
+}
+
+ssize_t ProcessExecutor::writeWithoutSignal(int fd, const char *data, size_t size)
+{
+    // Process may exit without reading all input. It should be an error of write, not SIGPIPE.
+    // SIGPIPE is blocked only in this thread, so signal dispositions of the process are kept.
+    sigset_t pipeMask, oldMask, pending;
+    sigemptyset(&pipeMask);
+    sigaddset(&pipeMask, SIGPIPE);
+    sigpending(&pending);
+    bool isPending = sigismember(&pending, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipeMask, &oldMask);
+
+    ssize_t length = write(fd, data, size);
+    int error = errno;
+    if (length < 0 && error == EPIPE && !isPending) {
+        // Discard SIGPIPE raised by this write
+        struct timespec zero = { 0, 0 };
+        while (sigtimedwait(&pipeMask, NULL, &zero) < 0 && errno == EINTR);
+    }
+
+    pthread_sigmask(SIG_SETMASK, &oldMask, NULL);
+    errno = error;
+    return length;
+}
+
+bool ProcessExecutor::writeInput()
+{
+    while (m_input >= 0 && m_inputOffset < m_inputData.size()) {
+        ssize_t length = writeWithoutSignal(m_input, m_inputData.data() + m_inputOffset, m_inputData.size() - m_inputOffset);
+        if (length > 0) {
+            m_inputOffset += length;
+            continue;
+        }
+        if (length < 0 && (errno == EAGAIN || errno == EINTR))
+            return true;
+
+        // EPIPE means that the process doesn't read anymore
+        Logger::warning(MSGID_CONFIGDSERVICE,
+                        LOG_PREPIX_FORMAT "Failed to write input (%d) : %s",
+                        LOG_PREPIX_ARGS, m_pid, strerror(errno));
+        break;
+    }
+    // Closing stdin gives EOF to the process
+    closeInput();
+    return false;
+}
+
+void ProcessExecutor::closeInput()
+{
+    if (m_input >= 0) {
+        close(m_input);
+        m_input = -1;
+    }
+    m_inputData.clear();
+    m_inputOffset = 0;
+    m_hasInput = false;
+}
+
+bool ProcessExecutor::reap(bool block)
+{
+    int status = 0;
+    pid_t pid = waitpid(m_pid, &status, block ? 0 : WNOHANG);
+
+    if (pid == 0 || (pid < 0 && errno == EINTR))
+        return false;
+
+    if (pid == m_pid && WIFEXITED(status))
+        m_exitStatus = WEXITSTATUS(status);
+    else
+        m_exitStatus = -1;
+    m_pid = 0;
+    closeInput();
+    return true;
+}
+
+void ProcessExecutor::kill()
+{
+    ::kill(-m_pid, SIGKILL);
+    if (m_output >= 0) {
+        close(m_output);
+        m_output = -1;
+    }
+    while (!reap(true));
+}
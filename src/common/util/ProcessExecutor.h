@@ -0,0 +1,89 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UTIL_PROCESS_EXECUTOR_H_
+#define UTIL_PROCESS_EXECUTOR_H_
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <sys/types.h>
+#include <glib.h>
+
+using namespace std;
+
+/*
+ * Runs a command with posix_spawn and captures its stdout.
+ *
+ * A command is executed with /bin/sh -c like popen, so shell builtins and word splitting work.
+ * If direct execution is enabled, a command without shell syntax (pipes, redirections,
+ * variables...) is split into an argument vector and executed without /bin/sh.
+ * The process is killed with its process group if it doesn't finish before the timeout.
+ * If input is given, it is streamed into stdin of the process while stdout is captured.
+ */
+class ProcessExecutor {
+public:
+    static const int MS_DEFAULT_TIMEOUT = 60000;
+
+    // Waits all executors until those are finished or timed out
+    static void waitAll(const vector<ProcessExecutor*> &executors);
+
+    ProcessExecutor();
+    virtual ~ProcessExecutor();
+
+    // Input for stdin of the next started process. stdin is inherited without it.
+    void setInput(const string &input);
+    // Execute commands without shell syntax directly. Shell builtins can't be used then.
+    void setDirect(bool isDirect);
+    bool start(const string &command, const vector<string> &args, int timeout = MS_DEFAULT_TIMEOUT);
+    bool wait();
+    // Kills the running process as timed out. It is used when the timeout is watched by main loop.
+    void expire();
+
+    // For main loop. Stdout of the running process, -1 after it is closed.
+    int getOutputFd();
+    // Reads available output without blocking. It returns false after EOF.
+    bool readOutput();
+
+    bool isRunning();
+    bool isTimeout();
+    int getExitStatus();
+    string &getOutput();
+
+private:
+    static void parseCommand(const string &command, const vector<string> &args, bool isDirect, vector<string> &argv);
+    static ssize_t writeWithoutSignal(int fd, const char *data, size_t size);
+
+    bool writeInput();
+    void closeInput();
+    bool reap(bool block);
+    void kill();
+
+    pid_t m_pid;
+    int m_output;
+    int m_input;
+    gint64 m_deadline;
+
+    bool m_isTimeout;
+    int m_exitStatus;
+    string m_console;
+    string m_inputData;
+    size_t m_inputOffset;
+    bool m_hasInput;
+    bool m_isDirect;
+};
+
+#endif // UTIL_PROCESS_EXECUTOR_H_
@@ -21,8 +21,10 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <glib.h>
+#include <algorithm>
 
 #include "Manager.h"
+#include "database/JsonDBSnapshot.h"
 #include "service/ErrorDB.h"
 #include "service/ls2/LS2BusFactory.h"
 #include "setting/Setting.h"
@@ -30,7 +32,15 @@
 #include "util/Platform.h"
 
 Manager::Manager()
-    : m_isLoaded(false)
+    : m_isLoaded(false),
+      m_reconfigureState(ReconfigureState_Idle),
+      m_reconfigureSourceId(0),
+      m_reconfigureDeadline(0),
+      m_requirePreProcessing(false),
+      m_requirePostProcessing(false),
+      m_sharedSnapshotGeneration(g_get_real_time()),
+      m_sharedPermissionGeneration(0),
+      m_getPermissionMatcher(Configd::NAME_GET_PERMISSION)
 {
     Logger::info(MSGID_MANAGER, LOG_PREPIX_FORMAT "Create GMainLoop", LOG_PREPIX_ARGS);
     m_mainLoop = g_main_loop_new(NULL, FALSE);
@@ -38,6 +48,8 @@ Manager::Manager()
 
 Manager::~Manager()
 {
+    if (m_reconfigureSourceId != 0)
+        g_source_remove(m_reconfigureSourceId);
     if (g_main_loop_is_running(m_mainLoop))
         g_main_loop_quit(m_mainLoop);
     g_main_loop_unref(m_mainLoop);
@@ -45,9 +57,14 @@ Manager::~Manager()
 
 void Manager::initialize()
 {
+    JsonDB::setPersistentSnapshotEnabled(Setting::getInstance().isDatabaseSnapshotEnabled());
+
     Logger::info(MSGID_MANAGER, LOG_PREPIX_FORMAT "Initialize Bus Instance", LOG_PREPIX_ARGS);
     Configd::getInstance()->initialize(m_mainLoop, this);
     Setting::getInstance().initialize();
+    // Image of previous run should not be read by clients
+    if (!Setting::getInstance().isSharedSnapshotEnabled() && Platform::isFileExist(JsonDBSnapshot::FILENAME_SHARED))
+        Platform::deleteFile(JsonDBSnapshot::FILENAME_SHARED);
     if (!load()) {
         Logger::debug(LOG_PREPIX_FORMAT "Error in manager load", LOG_PREPIX_ARGS);
     }
@@ -99,7 +116,7 @@ int Manager::onReconfigure(int timeout)
                  LOG_PREPIX_ARGS, timeout);
 
     if (timeout < Manager::MS_MINIMAL_DELAY) {
-        if (Manager::getInstance()->reconfigure(true, false))
+        if (!Manager::getInstance()->reconfigure(true, false))
             Logger::warning(MSGID_CONFIGDSERVICE, LOG_PREPIX_FORMAT "Error in reconfigure", LOG_PREPIX_ARGS);
     } else {
         if (!Manager::getInstance()->reconfigure(true, true, timeout))
@@ -178,6 +195,8 @@ bool Manager::load()
     }
 
     // Handle FactoryDB
+    // setConfigs updates factory database frequently but only a few keys at once
+    JsonDB::getFactoryInstance().setJournalEnabled(Setting::getInstance().isDatabaseJournalEnabled());
     JsonDB::getFactoryInstance().load(JsonDB::FILENAME_FACTORY_DB);
     if (!JsonDB::getFakeFactoryInstance().getDatabase().isNull()) {
         // FakeFactoryInstance is early database during snapshot-boot
@@ -197,6 +216,8 @@ bool Manager::load()
 
     // Read only selections are ready.
     // Configd tries to reconfigure whenever other selections are available.
+    // From now on, command selectors don't block main loop.
+    Layer::setAsyncSelectorEnabled(Setting::getInstance().isAsyncSelectorEnabled());
     Configuration::getInstance().setListener(this);
     if(isLoadExistDB) {
         Configuration::getInstance().selectAll();
@@ -210,42 +231,82 @@ bool Manager::load()
     return true;
 }
 
-bool Manager::reconfigure(bool runPreProcess, bool runPostProcess, int delayTime)
+gboolean Manager::_onReconfigureTimeout(gpointer ctx)
 {
-    static bool savedRunPreProcess = false;
-    static bool savedRunPostProcess = false;
+    Manager *manager = (Manager*)ctx;
+    manager->m_reconfigureSourceId = 0;
+    manager->runReconfigure();
+    return G_SOURCE_REMOVE;
+}
 
-    if (runPreProcess) savedRunPreProcess = true;
-    if (runPostProcess) savedRunPostProcess = true;
+bool Manager::reconfigure(bool runPreProcess, bool runPostProcess, int delayTime)
+{
+    if (runPreProcess) m_requirePreProcessing = true;
+    if (runPostProcess) m_requirePostProcessing = true;
+
+    gint64 now = g_get_monotonic_time() / 1000;
+    switch (m_reconfigureState) {
+    case ReconfigureState_Running:
+    case ReconfigureState_Rerun:
+        Logger::debug(LOG_PREPIX_FORMAT "Reconfigure is running. It will be done again", LOG_PREPIX_ARGS);
+        m_reconfigureState = ReconfigureState_Rerun;
+        return true;
+
+    case ReconfigureState_Idle:
+        m_reconfigureDeadline = now + MS_MAX_LATENCY;
+        break;
+
+    case ReconfigureState_Pending:
+        Logger::debug(LOG_PREPIX_FORMAT "Merge with pending reconfigure request", LOG_PREPIX_ARGS);
+        break;
+    }
 
-    if (m_reconfigureTimer.isWaiting()) {
-        Logger::debug(LOG_PREPIX_FORMAT "Clear another reconfigure request", LOG_PREPIX_ARGS);
-        m_reconfigureTimer.clear();
+    if (delayTime <= 0) {
+        runReconfigure();
+        return true;
     }
-    if (delayTime > 0) {
-        // This is blocking call but mainloop is alive.
-        Logger::debug(LOG_PREPIX_FORMAT "Wait reconfigure timeout (%d ms)", LOG_PREPIX_ARGS, delayTime);
-        if (!m_reconfigureTimer.wait(delayTime)) {
-            // 'false' return means another thread call 'clear'
-            // the thread will handle reconfigure
-            Logger::debug(LOG_PREPIX_FORMAT "Cleared by another reconfigure request", LOG_PREPIX_ARGS);
-            return false;
-        }
-        m_reconfigureTimer.clear();
+
+    // Each request extends waiting time to merge following requests, but not beyond deadline
+    scheduleReconfigure(std::min(now + delayTime, m_reconfigureDeadline) - now);
+    return true;
+}
+
+void Manager::scheduleReconfigure(gint64 delayTime)
+{
+    if (m_reconfigureSourceId != 0)
+        g_source_remove(m_reconfigureSourceId);
+
+    if (delayTime < 0)
+        delayTime = 0;
+    Logger::debug(LOG_PREPIX_FORMAT "Wait reconfigure timeout (%lld ms)", LOG_PREPIX_ARGS, (long long)delayTime);
+    m_reconfigureSourceId = g_timeout_add((guint)delayTime, &Manager::_onReconfigureTimeout, this);
+    m_reconfigureState = ReconfigureState_Pending;
+}
+
+void Manager::runReconfigure()
+{
+    if (m_reconfigureSourceId != 0) {
+        g_source_remove(m_reconfigureSourceId);
+        m_reconfigureSourceId = 0;
     }
 
+    bool runPreProcess = m_requirePreProcessing;
+    bool runPostProcess = m_requirePostProcessing;
+    m_requirePreProcessing = false;
+    m_requirePostProcessing = false;
+    m_reconfigureState = ReconfigureState_Running;
+
     // Removing main db file will ensure that reconfigure is needed
     // because of sudden power off or any other unexpected things happened.
     JsonDB::getMainInstance().clear();
 
     Logger::info(MSGID_CONFIGDSERVICE,
-                 LOG_PREPIX_FORMAT "Start Reconfigure - runPreProcess(%s), runPostProcess(%s), delayTime(%d)",
+                 LOG_PREPIX_FORMAT "Start Reconfigure - runPreProcess(%s), runPostProcess(%s)",
                  LOG_PREPIX_ARGS,
-                 savedRunPreProcess ? "true" : "false",
-                 savedRunPostProcess ? "true" : "false",
-                 delayTime);
+                 runPreProcess ? "true" : "false",
+                 runPostProcess ? "true" : "false");
 
-    if (savedRunPreProcess) {
+    if (runPreProcess) {
         Logger::debug(LOG_PREPIX_FORMAT "Start PreProcess", LOG_PREPIX_ARGS);
         if (!Configuration::getInstance().runPreProcess())
             Logger::warning(MSGID_CONFIGDSERVICE, LOG_PREPIX_FORMAT "Error in runPreProcess", LOG_PREPIX_ARGS);
@@ -255,11 +316,16 @@ bool Manager::reconfigure(bool runPreProcess, bool runPostProcess, int delayTime
 
     Configuration::getInstance().setListener(nullptr);
     Configuration::getInstance().selectAll();
-    Configuration::getInstance().fetchConfigs(JsonDB::getMainInstance(), &JsonDB::getPermissionInstance());
+    if (runPreProcess) {
+        // Pre-processing could change any layer files
+        Configuration::getInstance().fetchConfigs(JsonDB::getMainInstance(), &JsonDB::getPermissionInstance());
+    } else {
+        Configuration::getInstance().fetchChangedConfigs(JsonDB::getMainInstance(), &JsonDB::getPermissionInstance());
+    }
     Configuration::getInstance().fetchLayers(JsonDB::getMainInstance());
     Configuration::getInstance().setListener(this);
 
-    if (savedRunPostProcess) {
+    if (runPostProcess) {
         Logger::debug(LOG_PREPIX_FORMAT "Start PostProcess", LOG_PREPIX_ARGS);
         if (!Configuration::getInstance().runPostProcess(JsonDB::getMainInstance()))
             Logger::warning(MSGID_CONFIGDSERVICE, LOG_PREPIX_FORMAT "Error in runPostProcess", LOG_PREPIX_ARGS);
@@ -273,43 +339,86 @@ bool Manager::reconfigure(bool runPreProcess, bool runPostProcess, int delayTime
     updateUnifiedDatabase("reconfigure");
     writeDebugDatabase(JsonDB::FULLNAME_DEBUG_RECONFIGURE);
 
-    savedRunPreProcess = false;
-    savedRunPostProcess = false;
-    return true;
+    if (m_reconfigureState == ReconfigureState_Rerun) {
+        // Requests during reconfigure are merged into one more round
+        m_reconfigureState = ReconfigureState_Idle;
+        reconfigure(false, false, MS_MINIMAL_DELAY);
+    } else {
+        m_reconfigureState = ReconfigureState_Idle;
+    }
 }
 
 void Manager::updateUnifiedDatabase(string reason)
 {
     Logger::debug(LOG_PREPIX_FORMAT "Update Unified database (%s)",
                   LOG_PREPIX_ARGS, reason.c_str());
-    JsonDB oldUnifiedDB("Database to update unified database");
 
-    oldUnifiedDB.copy(JsonDB::getUnifiedInstance());
-    JsonDB::getUnifiedInstance().copy(JsonDB::getMainInstance());
-    JsonDB::getUnifiedInstance().merge(JsonDB::getFactoryInstance());
+    // Values are shared with source databases instead of duplicated.
+    // Databases never modify values in place, they replace them.
+    JsonDB unifiedDB("Database to update unified database");
+    unifiedDB.merge(JsonDB::getMainInstance());
+    unifiedDB.merge(JsonDB::getFactoryInstance());
 
     // volatile configs(set by factorywin) would be initialized when reconfigure is called,
     // merged to unified DB when setConfigs are called.
     if (reason == "reconfigure") {
         JsonDB::getVolatileInstance().clear();
     } else if (reason == "setConfigs") {
-        JsonDB::getUnifiedInstance().merge(JsonDB::getVolatileInstance());
+        unifiedDB.merge(JsonDB::getVolatileInstance());
     }
 
-    if (oldUnifiedDB.getDatabase() == JsonDB::getUnifiedInstance().getDatabase()) {
+    set<string> changedNames;
+    JsonDB::diff(JsonDB::getUnifiedInstance(), unifiedDB, changedNames);
+    if (changedNames.empty()) {
         Logger::debug(LOG_PREPIX_FORMAT "Same unified db (%s)",
                       LOG_PREPIX_ARGS, reason.c_str());
+        // Configs can become read-protected without any value change
+        if (m_sharedPermissionGeneration != JsonDB::getPermissionInstance().getGeneration())
+            publishUnifiedDatabase();
         return;
     }
 
-    Configd::getInstance()->postGetConfigs(JsonDB::getUnifiedInstance(), oldUnifiedDB);
+    // After swap, 'unifiedDB' has previous unified database
+    JsonDB::getUnifiedInstance().swap(unifiedDB);
+    publishUnifiedDatabase();
+    Configd::getInstance()->postGetConfigs(JsonDB::getUnifiedInstance(), unifiedDB, changedNames);
+
+    // Keep previous values of changed configs only
+    JsonDB beforeDB("Changed configs before update");
+    for (const string &fullName : changedNames) {
+        JValue value = pbnjson::Object();
+        if (unifiedDB.fetch(fullName, value))
+            beforeDB.insert(fullName, value[fullName]);
+    }
 
+    Logger::info(MSGID_CONFIGDSERVICE,
+                 LOG_PREPIX_FORMAT "%zu configs are changed by %s",
+                 LOG_PREPIX_ARGS, changedNames.size(), reason.c_str());
     string filename = "/tmp/configd_" + Platform::timeStr() + "_before_" + reason + ".json";
-    oldUnifiedDB.setFilename(filename);
-    if (!oldUnifiedDB.flush())
+    beforeDB.setFilename(filename);
+    if (!beforeDB.flush())
         Logger::warning(MSGID_CONFIGDSERVICE, LOG_PREPIX_FORMAT "Error in old unified database flush", LOG_PREPIX_ARGS);
 }
 
+void Manager::publishUnifiedDatabase()
+{
+    if (!Setting::getInstance().isSharedSnapshotEnabled())
+        return;
+
+    // Clients read it directly, so it should be updated before subscription replies.
+    // It is readable without permission check, so only public configs are published.
+    JValue publicConfigs = m_getPermissionMatcher.getPublicConfigs(JsonDB::getPermissionInstance(),
+                                                                   JsonDB::getUnifiedInstance().getDatabase());
+    m_sharedSnapshotGeneration++;
+    if (!JsonDBSnapshot::publish(JsonDBSnapshot::FILENAME_SHARED, publicConfigs, m_sharedSnapshotGeneration)) {
+        Logger::warning(MSGID_CONFIGDSERVICE, LOG_PREPIX_FORMAT "Error in unified database publish", LOG_PREPIX_ARGS);
+        // Stale image could expose configs which are read-protected now
+        Platform::deleteFile(JsonDBSnapshot::FILENAME_SHARED);
+        return;
+    }
+    m_sharedPermissionGeneration = JsonDB::getPermissionInstance().getGeneration();
+}
+
 void Manager::writeDebugDatabase(string fullname)
 {
     JValue json = pbnjson::Object();
@@ -27,7 +27,7 @@
 #include "config/Configuration.h"
 #include "database/JsonDB.h"
 #include "service/Configd.h"
-#include "util/Timer.h"
+#include "service/PermissionMatcher.h"
 #include "util/Logger.hpp"
 
 using namespace std;
@@ -39,6 +39,8 @@ public :
     static const int MS_MINIMAL_DELAY = 10;
     static const int MS_DEFAULT_DELAY = 1000;
     static const int MS_LSCALL_DELAY = 10000;
+    // Maximum time from the first request until actual reconfigure even if requests keep coming
+    static const int MS_MAX_LATENCY = 20000;
 
     static Manager* getInstance()
     {
@@ -66,16 +68,40 @@ public :
     void writeDebugDatabase(string fullname);
 
 private:
+    enum ReconfigureState {
+        ReconfigureState_Idle = 0,
+        ReconfigureState_Pending,       // Waiting for more requests until timer is expired
+        ReconfigureState_Running,
+        ReconfigureState_Rerun,         // Requested while running
+    };
+
+    static gboolean _onReconfigureTimeout(gpointer ctx);
+
     Manager();
 
     bool load();
     bool reconfigure(bool runPreProcess, bool runPostProcess, int delayTime = 0);
+    void runReconfigure();
+    void scheduleReconfigure(gint64 delayTime);
     void updateUnifiedDatabase(string reason);
+    void publishUnifiedDatabase();
     void updateFactoryDatabase(JValue configs, bool isVolatile);
 
     GMainLoop *m_mainLoop;
-    Timer m_reconfigureTimer;
     bool m_isLoaded;
+
+    ReconfigureState m_reconfigureState;
+    guint m_reconfigureSourceId;
+    gint64 m_reconfigureDeadline;
+    bool m_requirePreProcessing;
+    bool m_requirePostProcessing;
+
+    // Starts from current time to keep increasing after respawn
+    uint64_t m_sharedSnapshotGeneration;
+    // Permission DB generation which the shared snapshot is filtered with
+    uint64_t m_sharedPermissionGeneration;
+    // Configs which require "read" permission are not published
+    PermissionMatcher m_getPermissionMatcher;
 };
 
 #endif // _MANAGER_H_
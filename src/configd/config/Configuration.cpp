@@ -24,6 +24,7 @@
 
 #include "Environment.h"
 #include "Process.h"
+#include "util/Json.h"
 #include "util/Platform.h"
 #include "util/Logger.hpp"
 #include "util/BuildInfo.hpp"
@@ -61,8 +62,13 @@ Configuration::~Configuration()
     }
 }
 
-bool Configuration::insertLayer(Layer &layerInfo)
+bool Configuration::insertLayer(JValue layer)
 {
+    // Layer can't be copied. It is built in place and spliced into the position.
+    list<Layer> inserted;
+    inserted.emplace_back(layer);
+    Layer &layerInfo = inserted.front();
+
     auto position = m_layers.end();
     for (auto it = m_layers.begin(); it != m_layers.end(); ++it) {
         if (layerInfo.getName() == it->getName()) {
@@ -75,11 +81,8 @@ bool Configuration::insertLayer(Layer &layerInfo)
             position = it;
         }
     }
-    if (position == m_layers.end()) {
-        m_layers.push_back(layerInfo);
-    } else {
-        m_layers.insert(position, layerInfo);
-    }
+    m_layers.splice(position, inserted);
+    m_checkpoints.clear();
     return true;
 }
 
@@ -104,6 +107,7 @@ void Configuration::clear()
 {
     m_filePaths.clear();
     m_layers.clear();
+    m_checkpoints.clear();
     m_postProcessing = nullptr;
     m_preProcessing = nullptr;
     m_version = "";
@@ -121,7 +125,7 @@ bool Configuration::append(std::string filename)
 
     m_filePaths.push_back(filename);
 
-    JSchema schema = JSchema::fromFile(CONFIGLAYERS_SCHEMA);
+    const JSchema &schema = Json::getSchema(CONFIGLAYERS_SCHEMA);
     JValue configuration = JDomParser::fromFile(filename.c_str(), schema);
 
     if (!configuration.isValid() || configuration.isNull()) {
@@ -156,8 +160,7 @@ bool Configuration::append(std::string filename)
                             i);
             continue;
         }
-        Layer layerInfo(configuration["layers"][i]);
-        if (!insertLayer(layerInfo)) {
+        if (!insertLayer(configuration["layers"][i])) {
             Logger::warning(MSGID_CONFIGUREDATA,
                             LOG_PREPIX_FORMAT "insertLayer error",
                             LOG_PREPIX_ARGS);
@@ -240,8 +243,56 @@ void Configuration::fetchConfigs(JValue &database)
 
 void Configuration::fetchConfigs(JsonDB &jsonDB, JsonDB *permissionDB)
 {
-    for (auto it = m_layers.begin(); it != m_layers.end(); ++it) {
-        it->fetchConfigs(jsonDB, permissionDB);
+    fetchConfigs(jsonDB, permissionDB, 0);
+}
+
+// Same as fetchConfigs, but only layers from the lowest changed one are parsed again.
+// jsonDB is expected to be empty like fetchConfigs.
+void Configuration::fetchChangedConfigs(JsonDB &jsonDB, JsonDB *permissionDB)
+{
+    size_t from = 0;
+    if (m_checkpoints.size() == m_layers.size()) {
+        for (auto it = m_layers.begin(); it != m_layers.end(); ++it, ++from) {
+            FetchCheckpoint &checkpoint = m_checkpoints[from];
+            if (checkpoint.name != it->getName() || checkpoint.isSelected != it->isSelected())
+                break;
+            if (checkpoint.isSelected && checkpoint.selection != it->getSelection())
+                break;
+            if (checkpoint.stamp != it->getFilesStamp())
+                break;
+        }
+    }
+
+    // Lower layers are not changed. Merge their configs instead of parsing them again.
+    // Permission database isn't cleared by reconfigure, so it already has their permissions.
+    for (size_t index = 0; index < from; ++index) {
+        jsonDB.merge(m_checkpoints[index].configs);
+    }
+
+    Logger::info(MSGID_CONFIGURE,
+                 LOG_PREPIX_FORMAT "Reuse %zu of %zu layers in fetch",
+                 LOG_PREPIX_ARGS, from, m_layers.size());
+    fetchConfigs(jsonDB, permissionDB, from);
+}
+
+void Configuration::fetchConfigs(JsonDB &jsonDB, JsonDB *permissionDB, size_t from)
+{
+    m_checkpoints.resize(from);
+
+    size_t index = 0;
+    for (auto it = m_layers.begin(); it != m_layers.end(); ++it, ++index) {
+        if (index < from)
+            continue;
+
+        FetchCheckpoint checkpoint;
+        checkpoint.name = it->getName();
+        checkpoint.isSelected = it->isSelected();
+        checkpoint.selection = checkpoint.isSelected ? it->getSelection() : "";
+        checkpoint.stamp = it->getFilesStamp();
+        checkpoint.configs = pbnjson::Object();
+
+        it->fetchConfigs(jsonDB, permissionDB, &checkpoint.configs);
+        m_checkpoints.push_back(checkpoint);
     }
 }
 
@@ -276,6 +327,78 @@ void Configuration::fetchLayers(JsonDB &jsonDB)
 
 bool Configuration::runPostProcess(JsonDB &jsonDB)
 {
+    bool result = true;
+    bool isStream = false;
+    JValue commands = pbnjson::Array();
+
+    if (!m_postProcessing.isArray() || m_postProcessing.arraySize() == 0) {
+        Logger::info(MSGID_CONFIGURE,
+                     LOG_PREPIX_FORMAT "Empty post_process or Invalid post_process (%s)",
+                     LOG_PREPIX_ARGS, m_postProcessing.stringify("    ").c_str());
+        return true;
+    }
+
+    // JSON processes are applied to jsonDB in place. Adjacent command processes
+    // of the same kind (stream or file) are run together.
+    for (JValue postProcess : m_postProcessing.items()) {
+        Process process(postProcess);
+        bool isJson = (process.getType() == ProcessType_Json);
+
+        if (commands.arraySize() > 0 && (isJson || process.isStream() != isStream)) {
+            if (!runCommandPostProcess(jsonDB, commands, isStream))
+                result = false;
+            commands = pbnjson::Array();
+        }
+        if (!isJson) {
+            isStream = process.isStream();
+            commands.append(postProcess);
+            continue;
+        }
+        process.setDatabase(&jsonDB);
+        process.execute();
+    }
+    if (commands.arraySize() > 0 && !runCommandPostProcess(jsonDB, commands, isStream))
+        result = false;
+    return result;
+}
+
+bool Configuration::runStreamPostProcess(JsonDB &jsonDB, JValue processes)
+{
+    // Output of each process is given to the next one as input
+    string data = jsonDB.getDatabase().stringify();
+
+    for (JValue jvalue : processes.items()) {
+        Process process(jvalue);
+        process.setInput(data);
+        process.execute();
+        if (!process.isSucceeded()) {
+            Logger::warning(MSGID_CONFIGDSERVICE,
+                            LOG_PREPIX_FORMAT "Post process is failed. Database is not changed",
+                            LOG_PREPIX_ARGS);
+            return false;
+        }
+        data.swap(process.getOutput());
+    }
+
+    JValue database = JDomParser::fromString(data, Json::getSchema(CONFIGFEATUESLIST_SCHEMA));
+    if (!database.isObject()) {
+        Logger::warning(MSGID_CONFIGDSERVICE,
+                        LOG_PREPIX_FORMAT "Invalid output of post process",
+                        LOG_PREPIX_ARGS);
+        return false;
+    }
+
+    JsonDB postDB("After PostProcess");
+    postDB.merge(database);
+    jsonDB.copy(postDB);
+    return true;
+}
+
+bool Configuration::runCommandPostProcess(JsonDB &jsonDB, JValue processes, bool isStream)
+{
+    if (isStream)
+        return runStreamPostProcess(jsonDB, processes);
+
     bool result = true;
     JsonDB preDB("Before PostProcess"), postDB("After PostProcess");
 
@@ -301,13 +424,6 @@ bool Configuration::runPostProcess(JsonDB &jsonDB)
 
     umask(mask);
 
-    if (!m_postProcessing.isArray() || m_postProcessing.arraySize() == 0) {
-        Logger::info(MSGID_CONFIGURE,
-                     LOG_PREPIX_FORMAT "Empty post_process or Invalid post_process (%s)",
-                     LOG_PREPIX_ARGS, m_postProcessing.stringify("    ").c_str());
-        goto Done;
-    }
-
     if (!Platform::canWriteFile(jsonDB.getFilename())) {
         Logger::warning(MSGID_CONFIGDSERVICE,
                         LOG_PREPIX_FORMAT "Path (%s) is not ready to write",
@@ -328,11 +444,7 @@ bool Configuration::runPostProcess(JsonDB &jsonDB)
         goto Done;
     }
 
-    for (JValue postProcess : m_postProcessing.items()) {
-        Process process(std::move(postProcess));
-        process.setArgs(inputFilename, outputFilename);
-        process.execute();
-    }
+    Process::executeAll(processes, inputFilename, outputFilename);
 
     // Validate the output from post process feature list
     postDB.load(outputFilename);
@@ -361,10 +473,7 @@ bool Configuration::runPreProcess()
         return true;
     }
 
-    for (JValue preProcess : m_preProcessing.items()) {
-        Process process(preProcess);
-        process.execute();
-    }
+    Process::executeAll(m_preProcessing);
     return true;
 }
 
@@ -52,12 +52,13 @@ public:
     // fetch
     void fetchConfigs(JValue &database);
     void fetchConfigs(JsonDB &jsonDB, JsonDB *permissionDB = NULL);
+    void fetchChangedConfigs(JsonDB &jsonDB, JsonDB *permissionDB = NULL);
     void fetchLayers(JsonDB &jsonDB);
 
     // layer
     int getLayersSize();
     Layer* getLayer(string name);
-    bool insertLayer(Layer &layerInfo);
+    bool insertLayer(JValue layer);
     bool isLayersSorted();
     const string& getLayersVersion() const { return m_version; }
 
@@ -78,12 +79,28 @@ private:
     static const string POST_PROCESS_OP_PREFIX;
     static const string POST_PROCESS_IP_PREFIX;
 
+    // Configs which a layer contributed in the last fetch. Layers are fetched in priority
+    // order and 'where' conditions see lower layers, so a layer's result only stays valid
+    // while every layer below it keeps the same selection and files.
+    struct FetchCheckpoint {
+        string name;
+        bool isSelected;
+        string selection;
+        string stamp;
+        JValue configs;         // values are shared with fetched database
+    };
+
     Configuration();
 
+    void fetchConfigs(JsonDB &jsonDB, JsonDB *permissionDB, size_t from);
+    bool runCommandPostProcess(JsonDB &jsonDB, JValue processes, bool isStream);
+    bool runStreamPostProcess(JsonDB &jsonDB, JValue processes);
+
     JValue m_postProcessing;
     JValue m_preProcessing;
     std::vector<std::string> m_filePaths;
     std::list<Layer> m_layers;
+    std::vector<FetchCheckpoint> m_checkpoints;
     string m_version;
 };
 
@@ -14,6 +14,7 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <algorithm>
 #include <string>
 #include <fstream>
 #include <streambuf>
@@ -27,6 +28,9 @@
 #include "util/Logger.hpp"
 #include "util/Platform.h"
 
+map<string, Layer::CachedContent> Layer::s_contentCache;
+bool Layer::s_isAsyncSelectorEnabled = false;
+
 // TODO can be replace file schema?
 bool Layer::isValidLSSelector(const JValue &selector)
 {
@@ -108,6 +112,8 @@ Layer::Layer(JValue layer)
       m_selection(""),
       m_isSelected(false),
       m_listener(NULL),
+      m_commandWatchId(0),
+      m_commandTimeoutId(0),
       m_requirePreProcessing(false),
       m_requirePostProcessing(true), // basically, post processing is always needed.
       m_priority(0)
@@ -158,7 +164,124 @@ Layer::Layer(JValue layer)
 
 Layer::~Layer()
 {
+    stopCommand();
+}
+
+void Layer::setAsyncSelectorEnabled(bool enabled)
+{
+    s_isAsyncSelectorEnabled = enabled;
+}
+
+gboolean Layer::_onCommandOutput(GIOChannel *channel, GIOCondition condition, gpointer data)
+{
+    Layer *layer = (Layer*)data;
+
+    if (layer->m_command->readOutput())
+        return G_SOURCE_CONTINUE;
+
+    layer->m_commandWatchId = 0;
+    layer->finishCommand(false);
+    return G_SOURCE_REMOVE;
+}
+
+gboolean Layer::_onCommandTimeout(gpointer data)
+{
+    Layer *layer = (Layer*)data;
+
+    layer->m_commandTimeoutId = 0;
+    layer->finishCommand(true);
+    return G_SOURCE_REMOVE;
+}
+
+int Layer::getCommandTimeout(const JValue &selector)
+{
+    if (selector.hasKey("timeout") && selector["timeout"].isNumber() && selector["timeout"].asNumber<int>() > 0)
+        return selector["timeout"].asNumber<int>();
+    return ProcessExecutor::MS_DEFAULT_TIMEOUT;
+}
+
+bool Layer::startCommand(const JValue &selector, const string &alternativeSelection)
+{
+    if (m_command) {
+        Logger::info(MSGID_CONFIGURE,
+                     LOG_PREPIX_FORMAT_EXT "Command is already running",
+                     LOG_PREPIX_ARGS_EXT, getName().c_str());
+        return true;
+    }
+
+    int timeout = getCommandTimeout(selector);
+    unique_ptr<ProcessExecutor> command(new ProcessExecutor());
+    if (!command->start(selector["command"].asString(), vector<string>(), timeout)) {
+        Logger::warning(MSGID_CONFIGURE,
+                        LOG_PREPIX_FORMAT_EXT "Failed to start command",
+                        LOG_PREPIX_ARGS_EXT, getName().c_str());
+        return false;
+    }
 
+    // Channel doesn't own the fd. The executor closes it.
+    GIOChannel *channel = g_io_channel_unix_new(command->getOutputFd());
+    m_commandWatchId = g_io_add_watch(channel, (GIOCondition)(G_IO_IN | G_IO_HUP | G_IO_ERR),
+                                      _onCommandOutput, this);
+    g_io_channel_unref(channel);
+    m_commandTimeoutId = g_timeout_add(timeout, _onCommandTimeout, this);
+    m_command = std::move(command);
+    m_commandAlternative = alternativeSelection;
+    return true;
+}
+
+void Layer::finishCommand(bool isTimeout)
+{
+    string selection;
+    string alternativeSelection = m_commandAlternative;
+
+    // Output is closed already, so waiting exit of the process is short
+    if (isTimeout)
+        m_command->expire();
+    else if (m_command->wait())
+        selection = m_command->getOutput();
+    isTimeout = m_command->isTimeout();
+
+    stopCommand();
+    if (isTimeout) {
+        Logger::warning(MSGID_CONFIGURE,
+                        LOG_PREPIX_FORMAT_EXT "Command is timed out",
+                        LOG_PREPIX_ARGS_EXT, getName().c_str());
+    }
+
+    boost::trim(selection);
+    if (selection.empty() && !alternativeSelection.empty()) {
+        selection = alternativeSelection;
+    }
+    if (selection.empty()) {
+        Logger::warning(MSGID_CONFIGURE,
+                        LOG_PREPIX_FORMAT "Failed to find selection of '%s'",
+                        LOG_PREPIX_ARGS, m_name.c_str());
+        return;
+    }
+
+    Logger::info(MSGID_CONFIGURE,
+                 LOG_PREPIX_FORMAT "Succeed to find selection of %s : '%s'",
+                 LOG_PREPIX_ARGS, m_name.c_str(), selection.c_str());
+    if (!setSelection(selection)) {
+        Logger::warning(MSGID_CONFIGURE,
+                        LOG_PREPIX_FORMAT_EXT "Failed to select (Not Changed into 'invalid' type. Retry Next)",
+                        LOG_PREPIX_ARGS_EXT, m_name.c_str());
+    }
+}
+
+void Layer::stopCommand()
+{
+    if (m_commandWatchId != 0) {
+        g_source_remove(m_commandWatchId);
+        m_commandWatchId = 0;
+    }
+    if (m_commandTimeoutId != 0) {
+        g_source_remove(m_commandTimeoutId);
+        m_commandTimeoutId = 0;
+    }
+    // Running process is killed with its process group
+    m_command.reset();
+    m_commandAlternative.clear();
 }
 
 void Layer::printDebug()
@@ -239,11 +362,21 @@ void Layer::cancelCall()
 }
 
 JValue Layer::getMatchedConfigs(JValue& configs, JsonDB *jsonDB)
+{
+    CachedContent content;
+    Matcher::Properties properties;
+
+    content.configs = configs;
+    compileMatchers(content);
+    return getMatchedConfigs(content, jsonDB, properties);
+}
+
+JValue Layer::getMatchedConfigs(const CachedContent &content, JsonDB *jsonDB, Matcher::Properties &properties)
 {
     JValue matchedConfigs = pbnjson::Array();
-    for (int i = 0; i < configs.arraySize(); i++) {
-        if (!configs[i].hasKey("where")) {
-            matchedConfigs.append(configs[i]);
+    for (size_t i = 0; i < content.matchers.size(); i++) {
+        if (!content.matchers[i]) {
+            matchedConfigs.append(content.configs[i]);
             continue;
         }
 
@@ -251,9 +384,8 @@ JValue Layer::getMatchedConfigs(JValue& configs, JsonDB *jsonDB)
             continue;
         }
 
-        Matcher condition(configs[i]["where"]);
-        if (condition.checkCondition(jsonDB)) {
-            matchedConfigs.append(configs[i]);
+        if (content.matchers[i]->checkCondition(jsonDB, properties)) {
+            matchedConfigs.append(content.configs[i]);
             Logger::info(MSGID_CONFIGDSERVICE,
                          LOG_PREPIX_FORMAT "where condition is matched",
                          LOG_PREPIX_ARGS);
@@ -262,6 +394,21 @@ JValue Layer::getMatchedConfigs(JValue& configs, JsonDB *jsonDB)
     return matchedConfigs;
 }
 
+void Layer::compileMatchers(CachedContent &cached)
+{
+    cached.matchers.clear();
+    if (!cached.configs.isArray())
+        return;
+
+    for (int i = 0; i < cached.configs.arraySize(); i++) {
+        JValue config = cached.configs[i];
+        if (config.hasKey("where"))
+            cached.matchers.push_back(make_shared<Matcher>(config["where"]));
+        else
+            cached.matchers.push_back(nullptr);
+    }
+}
+
 JValue Layer::refineContent(JValue& content)
 {
     JValue resultArray = pbnjson::Array();
@@ -280,7 +427,46 @@ JValue Layer::refineContent(JValue& content)
     return content["configs"];
 }
 
-bool Layer::parseFiles(string &dirPath, JValue *database, JsonDB *jsonDB, JsonDB *permissionsDB)
+bool Layer::isCachedContent(const string &path, const struct stat &fileStat)
+{
+    auto it = s_contentCache.find(path);
+    if (it == s_contentCache.end())
+        return false;
+
+    return it->second.inode == fileStat.st_ino &&
+           it->second.size == fileStat.st_size &&
+           it->second.mtime.tv_sec == fileStat.st_mtim.tv_sec &&
+           it->second.mtime.tv_nsec == fileStat.st_mtim.tv_nsec;
+}
+
+const Layer::CachedContent *Layer::loadContent(const string &path)
+{
+    struct stat fileStat;
+    if (stat(path.c_str(), &fileStat) != 0) {
+        s_contentCache.erase(path);
+        return NULL;
+    }
+
+    if (isCachedContent(path, fileStat)) {
+        return &s_contentCache[path];
+    }
+
+    JValue content = JDomParser::fromFile(path.c_str());
+    if (!content.isValid()) {
+        s_contentCache.erase(path);
+        return NULL;
+    }
+
+    CachedContent &cached = s_contentCache[path];
+    cached.inode = fileStat.st_ino;
+    cached.size = fileStat.st_size;
+    cached.mtime = fileStat.st_mtim;
+    cached.configs = refineContent(content);
+    compileMatchers(cached);
+    return &cached;
+}
+
+bool Layer::parseFiles(string &dirPath, JValue *database, JsonDB *jsonDB, JsonDB *permissionsDB, JValue *contribution)
 {
     DIR *dir = opendir(dirPath.c_str());
     if (NULL == dir) {
@@ -293,6 +479,9 @@ bool Layer::parseFiles(string &dirPath, JValue *database, JsonDB *jsonDB, JsonDB
                   LOG_PREPIX_ARGS,
                   dirPath.c_str());
 
+    // Each property of 'where' conditions is fetched once in this directory.
+    // Properties of configs inserted by a file are fetched again for following files.
+    Matcher::Properties properties;
     struct dirent *targetFile = NULL;
     while (NULL != (targetFile = readdir(dir))) {
         string fileName = targetFile->d_name;
@@ -310,10 +499,8 @@ bool Layer::parseFiles(string &dirPath, JValue *database, JsonDB *jsonDB, JsonDB
             continue;
         }
 
-        JValue content = JDomParser::fromFile(Platform::concatPaths(dirPath, fileName).c_str());
-        JValue configs = pbnjson::Object();
-
-        if (!content.isValid()) {
+        const CachedContent *content = loadContent(Platform::concatPaths(dirPath, fileName));
+        if (content == NULL) {
             Logger::error(MSGID_JSON_PARSE_FILE_ERR,
                           LOG_PREPIX_FORMAT "Invalid JSON format '%s/%s'",
                           LOG_PREPIX_ARGS,
@@ -321,8 +508,7 @@ bool Layer::parseFiles(string &dirPath, JValue *database, JsonDB *jsonDB, JsonDB
             continue;
         }
 
-        configs = refineContent(content);
-        configs = getMatchedConfigs(configs, jsonDB);
+        JValue configs = getMatchedConfigs(*content, jsonDB, properties);
 
         if (!configs.isArray() || configs.arraySize() <= 0)
             continue;
@@ -341,8 +527,13 @@ bool Layer::parseFiles(string &dirPath, JValue *database, JsonDB *jsonDB, JsonDB
                                   LOG_PREPIX_ARGS,
                                   key.c_str());
                 }
+                if (contribution != NULL) {
+                    if (!contribution->hasKey(name))
+                        contribution->put(name, pbnjson::Object());
+                    (*contribution)[name].put(key, feature.second);
+                }
                 if (config.hasKey("permissions")) {
-                    if (!permissionsDB->insert(name, key, config["permissions"])) {
+                    if (!permissionsDB->insert(name, key, config["permissions"].duplicate())) {
                         Logger::debug(LOG_PREPIX_FORMAT "Failed to insert '%s' key in permission DB",
                                       LOG_PREPIX_ARGS,
                                       key.c_str());
@@ -350,6 +541,8 @@ bool Layer::parseFiles(string &dirPath, JValue *database, JsonDB *jsonDB, JsonDB
                 }
             }
         }
+        if (jsonDB != NULL)
+            Matcher::invalidateProperties(properties, name);
     }
 
     closedir(dir);
@@ -379,7 +572,7 @@ bool Layer::fetchConfigs(JValue &database)
     return true;
 }
 
-bool Layer::fetchConfigs(JsonDB &jsonDB, JsonDB *permissionDB)
+bool Layer::fetchConfigs(JsonDB &jsonDB, JsonDB *permissionDB, JValue *contribution)
 {
     if (!isSelected()) {
         Logger::debug(LOG_PREPIX_FORMAT_EXT "Fetch is skipped because it is not selected yet",
@@ -388,13 +581,47 @@ bool Layer::fetchConfigs(JsonDB &jsonDB, JsonDB *permissionDB)
     }
 
     string dirPath = getFullDirPath(true);
-    if (!parseFiles(dirPath, NULL, &jsonDB, permissionDB)) {
+    if (!parseFiles(dirPath, NULL, &jsonDB, permissionDB, contribution)) {
         return false;
     }
     return true;
 }
 
-bool Layer::findSelection(const JValue &selector, string &selection)
+string Layer::getFilesStamp()
+{
+    vector<string> stamps;
+    string stamp;
+
+    if (!isSelected())
+        return stamp;
+
+    string dirPath = getFullDirPath(true);
+    DIR *dir = opendir(dirPath.c_str());
+    if (NULL == dir)
+        return stamp;
+
+    struct dirent *targetFile = NULL;
+    while (NULL != (targetFile = readdir(dir))) {
+        string fileName = targetFile->d_name;
+        struct stat fileStat;
+
+        if (fileName == ".." || fileName == "." ||
+            stat(Platform::concatPaths(dirPath, fileName).c_str(), &fileStat) != 0)
+            continue;
+
+        stamps.push_back(fileName + ":" + to_string(fileStat.st_ino) + ":" + to_string(fileStat.st_size) + ":" +
+                         to_string(fileStat.st_mtim.tv_sec) + "." + to_string(fileStat.st_mtim.tv_nsec));
+    }
+    closedir(dir);
+
+    // readdir order isn't fixed
+    sort(stamps.begin(), stamps.end());
+    for (const string &fileStamp : stamps)
+        stamp += fileStamp + "/";
+    return stamp;
+}
+
+bool Layer::findSelection(const JValue &selector, string &selection, bool isAlternative)
 {
     string alternativeSelection;
     SelectorType type = getSelectorType(selector);
@@ -402,7 +629,7 @@ bool Layer::findSelection(const JValue &selector, string &selection)
     if (m_selection.empty() && selector.hasKey("alternative")) {
         Logger::debug(LOG_PREPIX_FORMAT_EXT "Try to select alternative",
                       LOG_PREPIX_ARGS_EXT, m_name.c_str());
-        if (!findSelection(selector["alternative"], alternativeSelection)) {
+        if (!findSelection(selector["alternative"], alternativeSelection, true)) {
             Logger::warning(MSGID_CONFIGURE,
                             LOG_PREPIX_FORMAT_EXT "Failed to get alternative",
                             LOG_PREPIX_ARGS_EXT, m_name.c_str());
@@ -419,7 +646,11 @@ bool Layer::findSelection(const JValue &selector, string &selection)
         break;
 
     case SelectorType_Command:
-        if (!Platform::executeCommand(selector["command"].asString(), selection)) {
+        // Alternative is needed right now, so it is executed synchronously
+        if (s_isAsyncSelectorEnabled && !isAlternative && startCommand(selector, alternativeSelection)) {
+            return true;
+        }
+        if (!Platform::executeCommand(selector["command"].asString(), selection, getCommandTimeout(selector))) {
             Logger::warning(MSGID_CONFIGURE,
                             LOG_PREPIX_FORMAT "Failed to execute command : %s",
                             LOG_PREPIX_ARGS, selector["command"].asString().c_str());
@@ -20,12 +20,18 @@
 #include <glib.h>
 #include <strings.h>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <vector>
+#include <sys/stat.h>
 
 #include <luna-service2/lunaservice.h>
 #include <pbnjson.hpp>
 
+#include "Matcher.h"
 #include "database/JsonDB.h"
 #include "service/AbstractBusFactory.h"
+#include "util/ProcessExecutor.h"
 
 using namespace std;
 using namespace pbnjson;
@@ -52,9 +58,16 @@ class Layer : public IHandleListener {
 public:
     static char* getSelectorTypeStr(const SelectorType& type);
 
+    // Command selectors run in child process and selection is set when its output arrives
+    static void setAsyncSelectorEnabled(bool enabled);
+
     Layer(JValue layer);
     virtual ~Layer();
 
+    // Running command selector refers to its layer, so layers can't be copied
+    Layer(const Layer&) = delete;
+    Layer& operator=(const Layer&) = delete;
+
     void printDebug();
 
     // LS2 related methods
@@ -63,9 +76,13 @@ public:
     void cancelCall();
 
     // fetches
-    static bool parseFiles(string &dirPath, JValue *database, JsonDB *jsonDB = NULL, JsonDB *permissionDB = NULL);
+    static bool parseFiles(string &dirPath, JValue *database, JsonDB *jsonDB = NULL, JsonDB *permissionDB = NULL,
+                           JValue *contribution = NULL);
     bool fetchConfigs(JValue &database);
-    bool fetchConfigs(JsonDB &jsonDB, JsonDB *permissionDB = NULL);
+    // contribution gets configs inserted by this layer. Values are shared with jsonDB.
+    bool fetchConfigs(JsonDB &jsonDB, JsonDB *permissionDB = NULL, JValue *contribution = NULL);
+    // Identity (name, inode, size, mtime) of files in selected directory
+    string getFilesStamp();
 
     // save & restore
     void fromJson(JValue json);
@@ -94,12 +111,39 @@ public:
     static JValue getMatchedConfigs(JValue& content, JsonDB *jsonDB);
 
 private:
+    // Refined 'configs' of a layer file. It is reused while the file is not changed.
+    struct CachedContent {
+        ino_t inode;
+        off_t size;
+        struct timespec mtime;
+        JValue configs;
+        // Compiled 'where' of each config. NULL if the config doesn't have it.
+        vector<shared_ptr<Matcher>> matchers;
+    };
+
+    static bool isCachedContent(const string &path, const struct stat &fileStat);
+    static const CachedContent *loadContent(const string &path);
+    static void compileMatchers(CachedContent &cached);
+    static JValue getMatchedConfigs(const CachedContent &content, JsonDB *jsonDB, Matcher::Properties &properties);
+
+    static map<string, CachedContent> s_contentCache;
+    static bool s_isAsyncSelectorEnabled;
+
+    // async command selector
+    static gboolean _onCommandOutput(GIOChannel *channel, GIOCondition condition, gpointer data);
+    static gboolean _onCommandTimeout(gpointer data);
+
+    static int getCommandTimeout(const JValue &selector);
+    bool startCommand(const JValue &selector, const string &alternativeSelection);
+    void finishCommand(bool isTimeout);
+    void stopCommand();
+
     static bool isValidLSSelector(const JValue &selector);
     static bool isValidStrSelector(const JValue &selector, const string key);
     static SelectorType getSelectorType(const JValue &selector);
 
     // recursive function
-    bool findSelection(const JValue &selector, string &selection);
+    bool findSelection(const JValue &selector, string &selection, bool isAlternative = false);
 
     // R/W members
     string m_selection;
@@ -107,6 +151,12 @@ private:
     LayerListener *m_listener;
     shared_ptr<ICall> m_call;
 
+    // Running command selector
+    unique_ptr<ProcessExecutor> m_command;
+    guint m_commandWatchId;
+    guint m_commandTimeoutId;
+    string m_commandAlternative;
+
     // R/O members
     JValue m_layer;
     JValue m_selector;
@@ -19,9 +19,34 @@
 #include "Matcher.h"
 #include "util/Logger.hpp"
 
+const map<string, Matcher::Operator> Matcher::OPERATORS = {
+    { "=", Operator_Equal },
+    { "!=", Operator_NotEqual },
+    { "in", Operator_In },
+    { "<", Operator_Less },
+    { ">", Operator_Greater },
+    { "<=", Operator_LessEqual },
+    { ">=", Operator_GreaterEqual },
+    { "prefix", Operator_Prefix }
+};
+
 Matcher::Matcher(const JValue& where)
 {
     m_where = where.duplicate();
+    m_isValid = compile(m_where, m_root);
+}
+
+void Matcher::invalidateProperties(Properties &properties, const string &categoryName)
+{
+    // Property names can be untrimmed or wildcard ("category.*")
+    string prefix = categoryName + ".";
+    for (auto it = properties.begin(); it != properties.end(); ) {
+        size_t start = it->first.find_first_not_of(" \t\r\n");
+        if (start != string::npos && it->first.compare(start, prefix.length(), prefix) == 0)
+            it = properties.erase(it);
+        else
+            ++it;
+    }
 }
 
 Matcher::~Matcher()
@@ -30,61 +55,175 @@ Matcher::~Matcher()
 }
 
 bool Matcher::validateCondition() {
-    if (!m_where.hasKey("prop") || !m_where.hasKey("val") || !m_where.hasKey("op")) {
-        Logger::warning(MSGID_CONFIGURE,
-                        LOG_PREPIX_FORMAT "where condition should be provided prop, val, op %s",
-                        LOG_PREPIX_ARGS, m_where.stringify("    ").c_str());
-        return false;
-    }
-
-    if (m_where["op"].asString() != "=") {
-        Logger::warning(MSGID_CONFIGURE,
-                        LOG_PREPIX_FORMAT "operation %s is not allowed",
-                        LOG_PREPIX_ARGS, m_where["op"].asString().c_str());
-        return false;
-    }
-    return true;
+    return m_isValid;
 }
 
 bool Matcher::checkCondition(JsonDB *jsonDB) {
-    Logger::info(MSGID_CONFIGURE,
-                 LOG_PREPIX_FORMAT "Check condition where: %s",
-                 LOG_PREPIX_ARGS, m_where.stringify().c_str());
+    Properties properties;
+    return checkCondition(jsonDB, properties);
+}
 
-    if (!validateCondition()) {
+bool Matcher::checkCondition(JsonDB *jsonDB, Properties &properties) {
+    Logger::debug(LOG_PREPIX_FORMAT "Check condition where: %s",
+                  LOG_PREPIX_ARGS, m_where.stringify().c_str());
+
+    if (!m_isValid) {
         Logger::warning(MSGID_CONFIGURE,
                         LOG_PREPIX_FORMAT "where state is not valid",
                         LOG_PREPIX_ARGS);
         return false;
     }
 
-    string key = m_where["prop"].asString();
-    JValue config = pbnjson::Object();
-    JValue configValue = pbnjson::Object();
-
     if (jsonDB == NULL) {
         Logger::warning(MSGID_CONFIGURE,
                         LOG_PREPIX_FORMAT "jsonDB are not existed",
                         LOG_PREPIX_ARGS);
         return false;
     }
-    else {
-        if (!jsonDB->fetch(key, config) || !config.hasKey(key)) {
+
+    vector<const Property*> values;
+    for (const string &prop : m_props) {
+        auto it = properties.find(prop);
+        if (it == properties.end()) {
+            Property property;
+            JValue config = pbnjson::Object();
+
+            property.isExist = jsonDB->fetchReference(prop, config) && config.hasKey(prop);
+            if (property.isExist)
+                property.value = config[prop];
+            it = properties.insert(make_pair(prop, property)).first;
+        }
+        values.push_back(&it->second);
+    }
+    return evaluate(m_root, values);
+}
+
+bool Matcher::compile(JValue where, Node &node)
+{
+    if (where.hasKey("and") || where.hasKey("or")) {
+        node.op = where.hasKey("and") ? Operator_And : Operator_Or;
+        JValue children = where.hasKey("and") ? where["and"] : where["or"];
+        if (!children.isArray() || children.arraySize() == 0) {
+            Logger::warning(MSGID_CONFIGURE,
+                            LOG_PREPIX_FORMAT "and/or should have array of conditions %s",
+                            LOG_PREPIX_ARGS, where.stringify("    ").c_str());
             return false;
         }
-        configValue = config[key];
+        node.children.resize(children.arraySize());
+        for (int i = 0; i < children.arraySize(); i++) {
+            if (!compile(children[i], node.children[i]))
+                return false;
+        }
+        return true;
+    }
+
+    if (where.hasKey("not")) {
+        node.op = Operator_Not;
+        node.children.resize(1);
+        return compile(where["not"], node.children[0]);
     }
 
-    return isMatched(configValue);
+    if (!where.hasKey("prop") || !where.hasKey("val") || !where.hasKey("op")) {
+        Logger::warning(MSGID_CONFIGURE,
+                        LOG_PREPIX_FORMAT "where condition should be provided prop, val, op %s",
+                        LOG_PREPIX_ARGS, where.stringify("    ").c_str());
+        return false;
+    }
+
+    auto it = OPERATORS.find(where["op"].asString());
+    if (it == OPERATORS.end() ||
+        (it->second == Operator_In && !where["val"].isArray()) ||
+        (it->second == Operator_Prefix && !where["val"].isString())) {
+        Logger::warning(MSGID_CONFIGURE,
+                        LOG_PREPIX_FORMAT "operation %s is not allowed",
+                        LOG_PREPIX_ARGS, where["op"].asString().c_str());
+        return false;
+    }
+    node.op = it->second;
+    node.val = where["val"];
+
+    string prop = where["prop"].asString();
+    for (node.prop = 0; node.prop < m_props.size(); node.prop++) {
+        if (m_props[node.prop] == prop)
+            break;
+    }
+    if (node.prop == m_props.size())
+        m_props.push_back(prop);
+    return true;
 }
 
-bool Matcher::isMatched(JValue configValue) {
-    bool returnValue = false;
-    std::string operation = m_where["op"].asString();
+bool Matcher::evaluate(const Node &node, const vector<const Property*> &properties)
+{
+    switch (node.op) {
+    case Operator_And:
+        for (const Node &child : node.children) {
+            if (!evaluate(child, properties))
+                return false;
+        }
+        return true;
 
-    if (operation == "=")
-        returnValue = (configValue == m_where["val"]);
+    case Operator_Or:
+        for (const Node &child : node.children) {
+            if (evaluate(child, properties))
+                return true;
+        }
+        return false;
 
-    return returnValue;
+    case Operator_Not:
+        return !evaluate(node.children[0], properties);
+
+    default:
+        if (!properties[node.prop]->isExist)
+            return false;
+        return compare(node.op, properties[node.prop]->value, node.val);
+    }
 }
 
+bool Matcher::compare(Operator op, const JValue &configValue, const JValue &val)
+{
+    switch (op) {
+    case Operator_Equal:
+        return configValue == val;
+
+    case Operator_NotEqual:
+        return configValue != val;
+
+    case Operator_In:
+        for (int i = 0; i < val.arraySize(); i++) {
+            if (configValue == val[i])
+                return true;
+        }
+        return false;
+
+    case Operator_Prefix:
+        return configValue.isString() && configValue.asString().compare(0, val.asString().size(), val.asString()) == 0;
+
+    default:
+        break;
+    }
+
+    // Numbers and strings are ordered. Others can't be compared.
+    int result = 0;
+    if (configValue.isNumber() && val.isNumber()) {
+        double left = configValue.asNumber<double>();
+        double right = val.asNumber<double>();
+        result = (left < right) ? -1 : (left > right) ? 1 : 0;
+    } else if (configValue.isString() && val.isString()) {
+        result = configValue.asString().compare(val.asString());
+    } else {
+        return false;
+    }
+
+    switch (op) {
+    case Operator_Less:
+        return result < 0;
+    case Operator_Greater:
+        return result > 0;
+    case Operator_LessEqual:
+        return result <= 0;
+    case Operator_GreaterEqual:
+        return result >= 0;
+    default:
+        return false;
+    }
+}
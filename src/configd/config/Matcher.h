@@ -18,6 +18,8 @@
 #define _MATCHER_H_
 
 #include <strings.h>
+#include <map>
+#include <vector>
 #include <pbnjson.hpp>
 
 #include "database/JsonDB.h"
@@ -25,16 +27,67 @@
 using namespace std;
 using namespace pbnjson;
 
+/*
+ * 'where' condition compiled into a predicate tree.
+ *
+ * Leaf is { "prop", "op", "val" } with op one of "=", "!=", "in", "<", ">",
+ * "<=", ">=" and "prefix". Leaves are combined with { "and": [ ... ] },
+ * { "or": [ ... ] } and { "not": { ... } }. Condition on a property which
+ * doesn't exist is never matched.
+ */
 class Matcher {
 public:
+    struct Property {
+        bool isExist;
+        JValue value;
+    };
+    // Properties fetched by checkCondition. Matchers checked against the same
+    // database can share it, so that each property is fetched only once.
+    typedef map<string, Property> Properties;
+
+    // Forget properties of the category, so that changed configs are fetched again
+    static void invalidateProperties(Properties &properties, const string &categoryName);
+
     Matcher(const JValue& where);
     ~Matcher();
     bool checkCondition(JsonDB *jsonDB);
+    bool checkCondition(JsonDB *jsonDB, Properties &properties);
     bool validateCondition();
 
 private:
-    bool isMatched(JValue configValue);
+    enum Operator {
+        Operator_Equal,
+        Operator_NotEqual,
+        Operator_In,
+        Operator_Less,
+        Operator_Greater,
+        Operator_LessEqual,
+        Operator_GreaterEqual,
+        Operator_Prefix,
+        Operator_And,
+        Operator_Or,
+        Operator_Not
+    };
+
+    struct Node {
+        Operator op;
+        size_t prop;            // index of m_props for leaf
+        JValue val;
+        vector<Node> children;
+    };
+
+    static const map<string, Operator> OPERATORS;
+
+    static bool compare(Operator op, const JValue &configValue, const JValue &val);
+
+    bool compile(JValue where, Node &node);
+    bool evaluate(const Node &node, const vector<const Property*> &properties);
+
     JValue m_where;
+    Node m_root;
+    // Properties referenced by leaves. Same property is listed only once.
+    vector<string> m_props;
+    bool m_isValid;
 };
 
 #endif /* _MATCHER_H_ */
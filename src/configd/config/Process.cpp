@@ -14,13 +14,56 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <boost/algorithm/string.hpp>
+
+#include "Matcher.h"
 #include "Process.h"
+#include "util/Json.h"
 #include "util/Logger.hpp"
 #include "util/Platform.h"
 
+void Process::executeAll(JValue processes, const string &first, const string &second)
+{
+    vector<shared_ptr<Process>> group;
+
+    if (!processes.isArray())
+        return;
+
+    for (JValue jvalue : processes.items()) {
+        shared_ptr<Process> process = make_shared<Process>(jvalue);
+        process->setArgs(first, second);
+
+        if (!process->isParallel())
+            executeGroup(group);
+        group.push_back(process);
+        if (!process->isParallel())
+            executeGroup(group);
+    }
+    executeGroup(group);
+}
+
+void Process::executeGroup(vector<shared_ptr<Process>> &group)
+{
+    vector<ProcessExecutor*> executors;
+
+    for (shared_ptr<Process> &process : group) {
+        process->start();
+        executors.push_back(&process->m_executor);
+    }
+    ProcessExecutor::waitAll(executors);
+    for (shared_ptr<Process> &process : group) {
+        process->finish();
+    }
+    group.clear();
+}
+
 Process::Process(JValue jvalue)
     : m_first(""),
-      m_second("")
+      m_second(""),
+      m_timeout(ProcessExecutor::MS_DEFAULT_TIMEOUT),
+      m_isParallel(false),
+      m_isStream(false),
+      m_jsonDB(NULL)
 {
     m_type = ProcessType_Invalid;
 
@@ -35,6 +78,19 @@ Process::Process(JValue jvalue)
     } else if (jvalue["process"].hasKey("json")) {
         m_type = ProcessType_Json;
     }
+    if (jvalue["process"].hasKey("timeout") && jvalue["process"]["timeout"].isNumber()) {
+        m_timeout = jvalue["process"]["timeout"].asNumber<int>();
+    }
+    if (jvalue["process"].hasKey("parallel") && jvalue["process"]["parallel"].isBoolean()) {
+        m_isParallel = jvalue["process"]["parallel"].asBool();
+    }
+    if (jvalue["process"].hasKey("stream") && jvalue["process"]["stream"].isBoolean()) {
+        m_isStream = jvalue["process"]["stream"].asBool();
+    }
+    // Commands run with /bin/sh unless direct execution is requested
+    if (jvalue["process"].hasKey("direct") && jvalue["process"]["direct"].isBoolean()) {
+        m_executor.setDirect(jvalue["process"]["direct"].asBool());
+    }
     m_jvalue = jvalue.duplicate();
 }
 
@@ -49,11 +105,59 @@ void Process::setArgs(string first, string second)
     m_second = second;
 }
 
+void Process::setDatabase(JsonDB *jsonDB)
+{
+    m_jsonDB = jsonDB;
+}
+
+void Process::setInput(const string &input)
+{
+    m_executor.setInput(input);
+}
+
 void Process::execute()
 {
+    start();
+    m_executor.wait();
+    finish();
+}
+
+bool Process::isParallel()
+{
+    return m_isParallel;
+}
+
+bool Process::isStream()
+{
+    return m_isStream;
+}
+
+bool Process::isSucceeded()
+{
+    return !m_executor.isTimeout() && m_executor.getExitStatus() == 0;
+}
+
+string &Process::getOutput()
+{
+    return m_executor.getOutput();
+}
+
+ProcessType Process::getType()
+{
+    return m_type;
+}
+
+void Process::start()
+{
+    vector<string> args;
+
     switch (m_type) {
     case ProcessType_Command:
-        executeCommand();
+        if (!m_isStream) {
+            args.push_back(m_first);
+            args.push_back(m_second);
+        }
+        m_executor.start(m_jvalue["process"]["command"].asString(), args, m_timeout);
         break;
 
     case ProcessType_Json:
@@ -65,18 +169,100 @@ void Process::execute()
     }
 }
 
-void Process::executeCommand()
+void Process::finish()
 {
-    string command = m_jvalue["process"]["command"].asString();
-    string console = Platform::executeCommand(command, m_first, m_second);
+    if (m_type != ProcessType_Command)
+        return;
+
+    if (m_isStream) {
+        Logger::info(MSGID_CONFIGURE,
+                     LOG_PREPIX_FORMAT "With stream : command(%s), exit(%d%s), output(%zu bytes)",
+                     LOG_PREPIX_ARGS, m_jvalue["process"]["command"].asString().c_str(),
+                     m_executor.getExitStatus(), m_executor.isTimeout() ? ", timeout" : "",
+                     m_executor.getOutput().size());
+        return;
+    }
+
+    string console = m_executor.getOutput();
+    boost::trim(console);
     Logger::info(MSGID_CONFIGURE,
-                 LOG_PREPIX_FORMAT "With arguments : command(%s), first(%s), second(%s), result(%s)",
-                 LOG_PREPIX_ARGS, command.c_str(), m_first.c_str(), m_second.c_str(), console.c_str());
+                 LOG_PREPIX_FORMAT "With arguments : command(%s), first(%s), second(%s), exit(%d%s), result(%s)",
+                 LOG_PREPIX_ARGS, m_jvalue["process"]["command"].asString().c_str(),
+                 m_first.c_str(), m_second.c_str(), m_executor.getExitStatus(),
+                 m_executor.isTimeout() ? ", timeout" : "", console.c_str());
 }
 
 void Process::executeJson()
 {
+    string filename = m_jvalue["process"]["json"].asString();
+    int applied = 0;
+
+    if (m_jsonDB == NULL) {
+        Logger::warning(MSGID_CONFIGURE,
+                        LOG_PREPIX_FORMAT "Database is not given for JSON process (%s)",
+                        LOG_PREPIX_ARGS, filename.c_str());
+        return;
+    }
+
+    JValue rules = JDomParser::fromFile(filename.c_str(), Json::getSchema(JSONPROCESS_SCHEMA));
+    if (!rules.isArray()) {
+        Logger::warning(MSGID_CONFIGURE,
+                        LOG_PREPIX_FORMAT "Invalid JSON process (%s)",
+                        LOG_PREPIX_ARGS, filename.c_str());
+        return;
+    }
+
+    for (JValue rule : rules.items()) {
+        if (applyJsonRule(rule))
+            applied++;
+    }
     Logger::info(MSGID_CONFIGURE,
-                 LOG_PREPIX_FORMAT "JSON PROCESS",
-                 LOG_PREPIX_ARGS);
+                 LOG_PREPIX_FORMAT "JSON process (%s) : %d/%zd rules are applied",
+                 LOG_PREPIX_ARGS, filename.c_str(), applied, rules.arraySize());
+}
+
+bool Process::applyJsonRule(JValue rule)
+{
+    // All conditions should be matched before any change is made
+    if (rule.hasKey("conditions")) {
+        JValue conditions = rule["conditions"];
+        if (conditions.isObject()) {
+            conditions = pbnjson::Array();
+            conditions.append(rule["conditions"]);
+        }
+        Matcher::Properties properties;
+        for (JValue condition : conditions.items()) {
+            Matcher matcher(condition);
+            if (!matcher.checkCondition(m_jsonDB, properties))
+                return false;
+        }
+    }
+
+    if (rule.hasKey("config")) {
+        JValue configs = rule["config"];
+        m_jsonDB->merge(configs);
+    }
+
+    // "copy" is { "target full name" : "source full name" }
+    if (rule.hasKey("copy")) {
+        for (JValue::KeyValue copy : rule["copy"].children()) {
+            string source = copy.second.asString();
+            JValue result = pbnjson::Object();
+
+            if (!m_jsonDB->fetch(source, result) || !result.hasKey(source)) {
+                Logger::warning(MSGID_CONFIGURE,
+                                LOG_PREPIX_FORMAT "Failed to copy : '%s' doesn't exist",
+                                LOG_PREPIX_ARGS, source.c_str());
+                continue;
+            }
+            m_jsonDB->insert(copy.first.asString(), result[source].duplicate());
+        }
+    }
+
+    if (rule.hasKey("delete")) {
+        for (JValue fullName : rule["delete"].items()) {
+            m_jsonDB->remove(fullName.asString());
+        }
+    }
+    return true;
 }
@@ -18,9 +18,13 @@
 #define _PROCESS_H_
 
 #include <iostream>
+#include <memory>
+#include <vector>
 #include <pbnjson.hpp>
 
 #include "Environment.h"
+#include "database/JsonDB.h"
+#include "util/ProcessExecutor.h"
 
 using namespace pbnjson;
 using namespace std;
@@ -33,21 +37,42 @@ enum ProcessType {
 
 class Process {
 public:
+    // Executes processes in order. Adjacent processes marked as "parallel" run concurrently.
+    static void executeAll(JValue processes, const string &first = "", const string &second = "");
+
     Process(JValue jvalue);
     virtual ~Process();
 
     void setArgs(string first, string second);
+    // JSON process is applied to this database directly
+    void setDatabase(JsonDB *jsonDB);
+    // Streamed process gets input over stdin instead of file arguments
+    void setInput(const string &input);
     void execute();
+    bool isParallel();
+    bool isStream();
+    bool isSucceeded();
+    string &getOutput();
+    ProcessType getType();
 
 private:
-    void executeCommand();
+    static void executeGroup(vector<shared_ptr<Process>> &group);
+
+    void start();
+    void finish();
     void executeJson();
+    bool applyJsonRule(JValue rule);
 
     string m_note;
     string m_first, m_second;
 
     ProcessType m_type;
     JValue m_jvalue;
+    int m_timeout;
+    bool m_isParallel;
+    bool m_isStream;
+    ProcessExecutor m_executor;
+    JsonDB *m_jsonDB;
 };
 
 #endif /* _PROCESS_H_ */
@@ -36,8 +36,15 @@ public:
 
     virtual string getPayload() = 0;
     virtual string clientName() = 0;
+    virtual string getUniqueToken() = 0;
     virtual bool isSubscription() = 0;
     virtual void respond(JValue payload) = 0;
+
+    // Values of db in payload can be serialized with cached text of db
+    virtual void respond(JValue payload, JsonDB &db)
+    {
+        respond(payload);
+    }
 };
 
 class IMessagesListener {
@@ -17,6 +17,7 @@
 #include <signal.h>
 #include <glib.h>
 #include <time.h>
+#include <vector>
 
 #include <pbnjson.hpp>
 
@@ -47,7 +48,9 @@ const LSSignal Configd::SIGNAL_TABLE[2] = {
 };
 
 Configd::Configd()
-    : m_configdListener(NULL)
+    : m_configdListener(NULL),
+      m_eachCount(0),
+      m_getPermissionMatcher(NAME_GET_PERMISSION)
 {
 
 }
@@ -96,8 +99,42 @@ void Configd::sendSignal(const string &name)
     AbstractBusFactory::getInstance()->getIHandle()->sendSignal(url, signalPayload.stringify());
 }
 
+string Configd::getSubscriptionKey(const string &name)
+{
+    return "getConfigs/" + name;
+}
+
+bool Configd::subscribeGetConfigs(shared_ptr<IMessage> request, JValue &requestPayload)
+{
+    bool result = true;
+    set<string> names;
+
+    for (JValue config : requestPayload["configNames"].items()) {
+        string categoryName, configName;
+        if (!JsonDB::split(config.asString(), categoryName, configName))
+            continue;
+        names.insert(categoryName + "." + configName);
+    }
+
+    for (const string &name : names) {
+        if (!AbstractBusFactory::getInstance()->getIMessages(getSubscriptionKey(name))->pushMessage(request)) {
+            result = false;
+            continue;
+        }
+        m_subscribedNames.insert(name);
+    }
+    return result;
+}
+
 void Configd::eachMessage(shared_ptr<IMessage> message, JsonDB &newDB, JsonDB &oldDB)
 {
+    m_eachCount++;
+
+    // Client can be subscribed with several changed configs
+    string token = message->getUniqueToken();
+    if (!token.empty() && !m_notifiedMessages.insert(token).second)
+        return;
+
     JValue requestPayload = JDomParser::fromString(message->getPayload());
     if (!requestPayload.isValid() || requestPayload.isNull()) {
         Logger::warning(MSGID_CONFIGDSERVICE,
@@ -139,7 +176,7 @@ void Configd::eachMessage(shared_ptr<IMessage> message, JsonDB &newDB, JsonDB &o
 
     newResponsePayload.put("returnValue", true);
     newResponsePayload.put("subscribed", true);
-    message->respond(newResponsePayload);
+    message->respond(newResponsePayload, newDB);
     Logger::debug(LOG_PREPIX_FORMAT "Subscription) Client (%s) Request (%s)",
                   LOG_PREPIX_ARGS,
                   message->clientName().c_str(),
@@ -151,31 +188,63 @@ void Configd::eachMessage(shared_ptr<IMessage> message, JsonDB &newDB, JsonDB &o
 
 void Configd::postGetConfigs(JsonDB &newDB, JsonDB &oldDB)
 {
-    Logger::info(MSGID_CONFIGDSERVICE, LOG_PREPIX_FORMAT "Start Post-getConfigs", LOG_PREPIX_ARGS);
-    shared_ptr<IMessages> container = AbstractBusFactory::getInstance()->getIMessages("getConfigs");
-    if (!container->each(*this, newDB, oldDB)) {
-        Logger::warning(MSGID_CONFIGDSERVICE, LOG_PREPIX_FORMAT "Error in postGetConfigs each", LOG_PREPIX_ARGS);
-    }
-    Logger::info(MSGID_CONFIGDSERVICE, LOG_PREPIX_FORMAT "End Post-getConfigs", LOG_PREPIX_ARGS);
+    set<string> changedNames;
+
+    JsonDB::diff(oldDB, newDB, changedNames);
+    postGetConfigs(newDB, oldDB, changedNames);
 }
 
-bool Configd::hasPermission(JValue permissions, string serviceName, string permissionType)
+void Configd::postGetConfigs(JsonDB &newDB, JsonDB &oldDB, const set<string> &changedNames)
 {
-    if (!permissions.hasKey(permissionType) || !permissions[permissionType].isArray())
-        return true;
+    Logger::info(MSGID_CONFIGDSERVICE, LOG_PREPIX_FORMAT "Start Post-getConfigs", LOG_PREPIX_ARGS);
+    set<string> changedCategories;
 
-    for (JValue permission : permissions[permissionType].items()) {
-        string permissionName = permission.asString();
-        if (permissionName == "*" || permissionName == serviceName)
-            return true;
+    for (const string &name : changedNames) {
+        changedCategories.insert(name.substr(0, name.find_last_of('.')) + ".*");
+    }
 
-        if (permissionName.substr(permissionName.length()-1) != "*" ||(permissionName.length()-1 > serviceName.length()))
-            continue;
+    // Walk smaller side of subscribed names and changed names
+    vector<string> names;
+    if (m_subscribedNames.size() < changedNames.size() + changedCategories.size()) {
+        for (const string &name : m_subscribedNames) {
+            if (changedNames.find(name) != changedNames.end() ||
+                changedCategories.find(name) != changedCategories.end())
+                names.push_back(name);
+        }
+    } else {
+        for (const string &name : changedNames) {
+            if (m_subscribedNames.find(name) != m_subscribedNames.end())
+                names.push_back(name);
+        }
+        for (const string &name : changedCategories) {
+            if (m_subscribedNames.find(name) != m_subscribedNames.end())
+                names.push_back(name);
+        }
+    }
 
-        if (serviceName.substr(0, permissionName.length()-1) == permissionName.substr(0, permissionName.length()-1))
-            return true;
+    m_notifiedMessages.clear();
+    for (const string &name : names) {
+        shared_ptr<IMessages> container = AbstractBusFactory::getInstance()->getIMessages(getSubscriptionKey(name));
+        m_eachCount = 0;
+        if (!container->each(*this, newDB, oldDB)) {
+            Logger::warning(MSGID_CONFIGDSERVICE,
+                            LOG_PREPIX_FORMAT "Error in postGetConfigs each (%s)",
+                            LOG_PREPIX_ARGS, name.c_str());
+            continue;
+        }
+        // Cancelled subscriptions are removed by bus, so nobody is subscribing this name anymore
+        if (m_eachCount == 0)
+            m_subscribedNames.erase(name);
     }
-    return false;
+    Logger::info(MSGID_CONFIGDSERVICE,
+                 LOG_PREPIX_FORMAT "End Post-getConfigs (%zu changed configs, %zu notified clients)",
+                 LOG_PREPIX_ARGS, changedNames.size(), m_notifiedMessages.size());
+    m_notifiedMessages.clear();
+}
+
+bool Configd::hasPermission(JValue permissions, string serviceName, string permissionType)
+{
+    return PermissionMatcher::Permission(permissions, permissionType).match(serviceName);
 }
 
 bool Configd::msgGetConfigs(JsonDB &db, JsonDB &permissionDB, shared_ptr<IMessage> request, JValue &response)
@@ -189,23 +258,21 @@ bool Configd::msgGetConfigs(JsonDB &db, JsonDB &permissionDB, shared_ptr<IMessag
         return false;
     }
 
+    // Response only refers to values in database. It is serialized without any copy.
     for (JValue config : requestPayload["configNames"].items()) {
         string fullName = config.asString();
-        if (!db.fetch(fullName, configs)) {
+        if (!db.fetchReference(fullName, configs)) {
             missingConfigs.append(fullName);
             continue;
         }
     }
 
-    JValue responseConfigs = configs.duplicate();
+    JValue responseConfigs = pbnjson::Object();
     for (JValue::KeyValue feature : configs.children()) {
         std::string key = feature.first.asString();
-        JValue permissions = pbnjson::Object();
-        if (!permissionDB.fetch(key, permissions)) {
-            continue;
-        }
-        if (!hasPermission(permissions[key], serviceName, NAME_GET_PERMISSION)) {
-            responseConfigs.remove(key);
+        if (m_getPermissionMatcher.hasPermission(permissionDB, key, serviceName)) {
+            responseConfigs.put(key, feature.second);
+        } else {
             missingConfigs.append(key);
             Logger::debug(LOG_PREPIX_FORMAT "Subscription) Client (%s) has no permission to get",
                           LOG_PREPIX_ARGS,
@@ -231,7 +298,7 @@ bool Configd::getConfigs(LSMessage &message)
     bool returnValue = true;
     bool subscribed = false;
 
-    JSchema schema = JSchema::fromFile(GETCONFIGS_SCHEMA);
+    const JSchema &schema = Json::getSchema(GETCONFIGS_SCHEMA);
     requestPayload = JDomParser::fromString(request->getPayload(), schema);
     if (requestPayload.isNull()) {
         errorCode = ErrorDB::ERRORCODE_INVALID_PARAMETER;
@@ -251,7 +318,7 @@ bool Configd::getConfigs(LSMessage &message)
 
     if (request->isSubscription()) {
         subscribed = true;
-        if (!AbstractBusFactory::getInstance()->getIMessages("getConfigs")->pushMessage(request)) {
+        if (!subscribeGetConfigs(request, requestPayload)) {
             Logger::warning(MSGID_CONFIGDSERVICE,
                             LOG_PREPIX_FORMAT "Error in pushMessage",
                             LOG_PREPIX_ARGS);
@@ -274,7 +341,7 @@ Exit:
         responsePayload.put("errorText", ErrorDB::getErrorText(errorCode));
     }
 
-    request->respond(responsePayload);
+    request->respond(responsePayload, JsonDB::getUnifiedInstance());
     Logger::info(MSGID_CONFIGDSERVICE, LOG_PREPIX_FORMAT "End Handle-getConfigs", LOG_PREPIX_ARGS);
     Logger::verbose(LOG_PREPIX_FORMAT "Client (%s) Response (%s)",
                     LOG_PREPIX_ARGS,
@@ -308,7 +375,7 @@ bool Configd::setConfigs(LSMessage &message)
     int errorCode = ErrorDB::ERRORCODE_UNKNOWN;
     bool returnValue = true;
 
-    JSchema schema = JSchema::fromFile(SETCONFIGS_SCHEMA);
+    const JSchema &schema = Json::getSchema(SETCONFIGS_SCHEMA);
     requestPayload = JDomParser::fromString(request->getPayload(), schema);
 
     if (requestPayload.isNull()) {
@@ -379,7 +446,7 @@ bool Configd::reconfigure(LSMessage &message)
     bool returnValue = true;
 
     int timeout = -1;
-    JSchema schema = JSchema::fromFile(RECONFIGS_SCHEMA);
+    const JSchema &schema = Json::getSchema(RECONFIGS_SCHEMA);
     requestPayload = JDomParser::fromString(request->getPayload(), schema);
 
     if (requestPayload.isNull()) {
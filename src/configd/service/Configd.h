@@ -18,12 +18,14 @@
 #define _CONFIGD_H_
 
 #include <iostream>
+#include <set>
 #include <stdint.h>
 
 #include <pbnjson.hpp>
 #include <service/AbstractBusFactory.h>
 
 #include "database/JsonDB.h"
+#include "service/PermissionMatcher.h"
 
 using namespace std;
 using namespace pbnjson;
@@ -58,6 +60,7 @@ public:
 
     virtual void initialize(GMainLoop *mainLoop, ConfigdListener *listener);
     virtual void postGetConfigs(JsonDB &newDB, JsonDB &oldDB);
+    virtual void postGetConfigs(JsonDB &newDB, JsonDB &oldDB, const set<string> &changedNames);
     virtual void sendSignal(const string &name);
 
     // IMessagesListener
@@ -97,8 +100,23 @@ protected:
 
     virtual bool msgGetConfigs(JsonDB &db, JsonDB &permissionDB, shared_ptr<IMessage> request, JValue &responsePayload);
 
+    // getConfigs subscriptions are added with one key per requested config name
+    // so that only clients of changed configs are notified.
+    static string getSubscriptionKey(const string &name);
+    bool subscribeGetConfigs(shared_ptr<IMessage> request, JValue &requestPayload);
+
     ConfigdListener *m_configdListener;
 
+    // Config names ("category.config" or "category.*") which have been subscribed.
+    // Names without subscribers are pruned when their configs are changed.
+    set<string> m_subscribedNames;
+    // Messages which are already handled in current postGetConfigs
+    set<string> m_notifiedMessages;
+    // Subscribers visited by current IMessages::each
+    size_t m_eachCount;
+    // Compiled "read" permissions of the permission DB
+    PermissionMatcher m_getPermissionMatcher;
+
 };
 
 #endif // _CONFIGD_H_
@@ -0,0 +1,173 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "PermissionMatcher.h"
+
+#include "Logging.h"
+#include "util/Logger.hpp"
+
+PermissionMatcher::Permission::Permission(const JValue &permissions, const string &permissionType)
+    : m_isPublic(true)
+{
+    m_prefixes.push_back(Node());
+
+    if (!permissions.hasKey(permissionType) || !permissions[permissionType].isArray())
+        return;
+
+    m_isPublic = false;
+    for (JValue permission : permissions[permissionType].items()) {
+        string permissionName = permission.asString();
+        if (permissionName.empty())
+            continue;
+
+        if (permissionName[permissionName.length() - 1] == '*')
+            addPrefix(permissionName.substr(0, permissionName.length() - 1));
+        else
+            m_names.insert(permissionName);
+    }
+}
+
+void PermissionMatcher::Permission::addPrefix(const string &prefix)
+{
+    int node = 0;
+
+    for (char c : prefix) {
+        auto it = m_prefixes[node].children.find(c);
+        if (it != m_prefixes[node].children.end()) {
+            node = it->second;
+            continue;
+        }
+        m_prefixes.push_back(Node());
+        m_prefixes[node].children[c] = m_prefixes.size() - 1;
+        node = m_prefixes.size() - 1;
+    }
+    m_prefixes[node].isTerminal = true;
+}
+
+bool PermissionMatcher::Permission::match(const string &serviceName) const
+{
+    if (m_isPublic || m_names.find(serviceName) != m_names.end())
+        return true;
+
+    // "*" is an empty prefix, so it is terminal at root node
+    int node = 0;
+    for (size_t i = 0; ; ++i) {
+        if (m_prefixes[node].isTerminal)
+            return true;
+        if (i == serviceName.length())
+            return false;
+
+        auto it = m_prefixes[node].children.find(serviceName[i]);
+        if (it == m_prefixes[node].children.end())
+            return false;
+        node = it->second;
+    }
+}
+
+bool PermissionMatcher::Permission::isPublic() const
+{
+    // "*" is terminal at root node
+    return m_isPublic || m_prefixes[0].isTerminal;
+}
+
+PermissionMatcher::PermissionMatcher(const string &permissionType)
+    : m_permissionType(permissionType),
+      m_permissionDB(NULL),
+      m_generation(0)
+{
+}
+
+PermissionMatcher::~PermissionMatcher()
+{
+}
+
+void PermissionMatcher::compile(JsonDB &permissionDB)
+{
+    m_permissions.clear();
+    m_verdicts.clear();
+    m_permissionDB = &permissionDB;
+    m_generation = permissionDB.getGeneration();
+
+    JValue &database = permissionDB.getDatabase();
+    if (!database.isObject())
+        return;
+
+    for (JValue::KeyValue category : database.children()) {
+        string categoryName = category.first.asString();
+        if (!category.second.isObject())
+            continue;
+
+        for (JValue::KeyValue config : category.second.children()) {
+            m_permissions[categoryName + "." + config.first.asString()] =
+                make_shared<const Permission>(config.second, m_permissionType);
+        }
+    }
+    Logger::debug(LOG_PREPIX_FORMAT "Compiled %zu '%s' permissions",
+                  LOG_PREPIX_ARGS, m_permissions.size(), m_permissionType.c_str());
+}
+
+bool PermissionMatcher::hasPermission(JsonDB &permissionDB, const string &fullName, const string &serviceName)
+{
+    if (m_permissionDB != &permissionDB || m_generation != permissionDB.getGeneration())
+        compile(permissionDB);
+
+    auto permission = m_permissions.find(fullName);
+    if (permission == m_permissions.end())
+        return true;
+
+    // Service names can't have '\n'
+    string verdictKey = serviceName + '\n' + fullName;
+    auto verdict = m_verdicts.find(verdictKey);
+    if (verdict != m_verdicts.end())
+        return verdict->second;
+
+    bool result = permission->second->match(serviceName);
+    if (m_verdicts.size() >= MAX_VERDICTS)
+        m_verdicts.clear();
+    m_verdicts[verdictKey] = result;
+    return result;
+}
+
+JValue PermissionMatcher::getPublicConfigs(JsonDB &permissionDB, const JValue &database)
+{
+    if (m_permissionDB != &permissionDB || m_generation != permissionDB.getGeneration())
+        compile(permissionDB);
+
+    JValue publicConfigs = pbnjson::Object();
+    if (!database.isObject())
+        return publicConfigs;
+
+    for (JValue::KeyValue category : database.children()) {
+        if (!category.second.isObject()) {
+            publicConfigs.put(category.first, category.second);
+            continue;
+        }
+
+        // Categories without any protected config are shared as is
+        string categoryName = category.first.asString();
+        JValue configs = pbnjson::Object();
+        bool isFiltered = false;
+        for (JValue::KeyValue config : category.second.children()) {
+            auto permission = m_permissions.find(categoryName + "." + config.first.asString());
+            if (permission != m_permissions.end() && !permission->second->isPublic())
+                isFiltered = true;
+            else
+                configs.put(config.first, config.second);
+        }
+        publicConfigs.put(category.first, isFiltered ? configs : category.second);
+    }
+    return publicConfigs;
+}
@@ -0,0 +1,88 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _PERMISSION_MATCHER_H_
+#define _PERMISSION_MATCHER_H_
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <pbnjson.hpp>
+
+#include "database/JsonDB.h"
+
+using namespace std;
+using namespace pbnjson;
+
+/*
+ * Permission DB compiled for one permission type (for example "read").
+ *
+ * Each config key gets an immutable Permission which has a hash set of exact
+ * service names and a prefix trie of wildcard ("prefix*") service names.
+ * Verdicts are memoized per (service, key) until the permission DB is changed.
+ */
+class PermissionMatcher {
+public:
+    class Permission {
+    public:
+        Permission(const JValue &permissions, const string &permissionType);
+
+        bool match(const string &serviceName) const;
+        bool isPublic() const;
+
+    private:
+        struct Node {
+            Node() : isTerminal(false) {};
+
+            map<char, int> children;
+            bool isTerminal;
+        };
+
+        void addPrefix(const string &prefix);
+
+        bool m_isPublic;
+        unordered_set<string> m_names;
+        vector<Node> m_prefixes;
+    };
+
+    static const size_t MAX_VERDICTS = 4096;
+
+    PermissionMatcher(const string &permissionType);
+    virtual ~PermissionMatcher();
+
+    bool hasPermission(JsonDB &permissionDB, const string &fullName, const string &serviceName);
+    // Copy of database without configs which are not public for this permission type
+    JValue getPublicConfigs(JsonDB &permissionDB, const JValue &database);
+
+private:
+    void compile(JsonDB &permissionDB);
+
+    string m_permissionType;
+
+    JsonDB *m_permissionDB;
+    uint64_t m_generation;
+
+    // Keys without permission are not in m_permissions
+    unordered_map<string, shared_ptr<const Permission>> m_permissions;
+    unordered_map<string, bool> m_verdicts;
+};
+
+#endif // _PERMISSION_MATCHER_H_
@@ -31,6 +31,11 @@ void MessageAdapter::respond(JValue payload)
     m_message.respond(payload.stringify().c_str());
 }
 
+void MessageAdapter::respond(JValue payload, JsonDB &db)
+{
+    m_message.respond(db.stringify(payload).c_str());
+}
+
 bool MessageAdapter::isSubscription()
 {
     return m_message.isSubscription();
@@ -51,6 +56,14 @@ string MessageAdapter::clientName()
     return name;
 }
 
+string MessageAdapter::getUniqueToken()
+{
+    const char* token = m_message.getUniqueToken();
+    if (token == NULL)
+        return "";
+    return token;
+}
+
 Message& MessageAdapter::getMessage()
 {
     return m_message;
@@ -35,9 +35,11 @@ public:
 
     // IMessage
     virtual void respond(JValue payload);
+    virtual void respond(JValue payload, JsonDB &db);
     virtual bool isSubscription();
     virtual string getPayload();
     virtual string clientName();
+    virtual string getUniqueToken();
 
     // Local Method
     Message& getMessage();
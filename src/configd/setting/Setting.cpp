@@ -184,6 +184,42 @@ string Setting::getLogPath()
     return value.asString();
 }
 
+bool Setting::isDatabaseSnapshotEnabled()
+{
+    JValue value = m_configuration["database"]["snapshot"];
+    if (!value.isBoolean()) {
+        return false;
+    }
+    return value.asBool();
+}
+
+bool Setting::isDatabaseJournalEnabled()
+{
+    JValue value = m_configuration["database"]["journal"];
+    if (!value.isBoolean()) {
+        return false;
+    }
+    return value.asBool();
+}
+
+bool Setting::isSharedSnapshotEnabled()
+{
+    JValue value = m_configuration["database"]["sharedSnapshot"];
+    if (!value.isBoolean()) {
+        return false;
+    }
+    return value.asBool();
+}
+
+bool Setting::isAsyncSelectorEnabled()
+{
+    JValue value = m_configuration["selector"]["async"];
+    if (!value.isBoolean()) {
+        return false;
+    }
+    return value.asBool();
+}
+
 bool Setting::isSnapshotBoot()
 {
     return m_isSnapshotBoot;
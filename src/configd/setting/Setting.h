@@ -53,6 +53,10 @@ public:
     LogType getLogType();
     LogLevel getLogLevel();
     string getLogPath();
+    bool isDatabaseSnapshotEnabled();
+    bool isDatabaseJournalEnabled();
+    bool isSharedSnapshotEnabled();
+    bool isAsyncSelectorEnabled();
 
     bool isSnapshotBoot();
     bool isRespawned();
@@ -17,7 +17,9 @@
 #include <semaphore.h>
 
 #include "libconfigd.h"
+#include "libconfigd_snapshot.h"
 #include "Logging.h"
+#include "SnapshotFormat.h"
 
 #define GETCONFIGS_METHOD "palm://com.webos.service.config/getConfigs"
 #define SETCONFIGS_METHOD "palm://com.webos.service.config/setConfigs"
@@ -33,6 +35,8 @@ static bool configd_getConfigsUnsafe(LSHandle *lsHandle, jvalue_ref queryObject,
 static bool config_cbReLoadConfigs(LSHandle *lsHandle, LSMessage *message, void *userData);
 static bool config_cbResultConfigs(LSHandle *lsHandle, LSMessage *message, void *userData);
 static void config_evaluateMissingConfigsSafe();
+static GSList *config_publishSnapshotUnsafe(jvalue_ref changedNames);
+static void config_notifyKeyWatchers(GSList *notifications);
 
 /**
  * usage example
@@ -70,6 +74,752 @@ static int32_t configUpdateWaitingLsCount = 0;
 static bool configReLoadDone = false;
 static GHashTable *configWatchers = NULL;
 static LSHandle *configLSHandle = NULL;
+static uint64_t configSharedGeneration = 0;
+
+/**
+ * Previous values of configs changed by local setConfigs.
+ * It is used to restore them if setConfigs is failed.
+ */
+typedef struct {
+    jvalue_ref oldValues;   // key -> previous value
+    jvalue_ref addedKeys;   // key -> true, for configs which didn't exist
+} ConfigUndoLog;
+
+/**
+ * Immutable copy of configCacheObj for readers.
+ *
+ * configCacheObj is only accessed by writers under configCacheLock.
+ * Whenever it is changed, writers publish a new snapshot and retire the old one.
+ * Readers never take configCacheLock (once the first getConfigs reply is received),
+ * they count themselves in configSnapshotReaders of the current epoch while using the snapshot.
+ * Writers tag retired snapshots with the epoch and advance the epoch whenever readers
+ * of the previous epoch are gone. A snapshot retired in epoch E is freed once the epoch
+ * reaches E + 2, because no reader of epoch E or older can remain then.
+ * So a long reader delays only the snapshots retired while it reads.
+ */
+typedef struct {
+    const char *str;
+    gsize len;
+} ConfigName;
+
+typedef enum {
+    ConfigValueType_Json = 0,
+    ConfigValueType_Boolean,
+    ConfigValueType_Integer,
+    ConfigValueType_Double,
+    ConfigValueType_String
+} ConfigValueType;
+
+/**
+ * Config value decoded once when snapshot is published.
+ * Getters return primitive values without JSON traversal or conversion.
+ * Values of unchanged configs are shared by following snapshots.
+ */
+typedef struct {
+    gint refCount;
+    ConfigName name;
+    ConfigValueType type;
+    bool boolean;
+    int64_t integer;
+    double number;
+    ConversionResultFlags int32Result; // jnumber_get_i32 result of numbers
+    int32_t int32;
+    ConfigName string;
+    jvalue_ref json;
+} ConfigValue;
+
+/**
+ * Resolved config name for constant time lookup.
+ * index is the slot of this handle in snapshots published after the handle is created.
+ */
+struct ConfigHandle {
+    ConfigName name;
+    guint index;
+};
+typedef struct ConfigHandle ConfigHandle;
+
+typedef struct ConfigSnapshot {
+    GHashTable *values; // ConfigName -> ConfigValue decoded from configCacheObj
+    ConfigValue **slots; // ConfigHandle index -> ConfigValue (no ownership)
+    guint slotCount;
+    gint retiredEpoch;
+    struct ConfigSnapshot *retiredNext;
+} ConfigSnapshot;
+
+/**
+ * Watcher of a config name or names starting with prefix ("prefix*")
+ */
+typedef struct {
+    ConfigName name;
+    bool isPrefix;
+    configdNotify func;
+    void *context;
+} ConfigKeyWatch;
+
+typedef struct {
+    configdNotify func;
+    void *context;
+    jvalue_ref changedObjects;
+} ConfigKeyNotification;
+
+static GSList *configKeyWatchers = NULL;
+
+static GHashTable *configHandles = NULL; // ConfigName -> ConfigHandle
+static GMutex configHandleLock;
+
+static ConfigSnapshot *configSnapshot = NULL;
+static ConfigSnapshot *configRetiredSnapshots = NULL;
+static gint configSnapshotEpoch = 0;
+static gint configSnapshotReaders[2] = { 0, 0 }; // Readers of even and odd epochs
+static GMutex configRetiredLock;
+
+static guint config_hashName(gconstpointer key)
+{
+    const ConfigName *name = (const ConfigName *) key;
+    guint hash = 5381;
+    gsize i;
+
+    for (i = 0; i < name->len; i++)
+    {
+        hash = (hash << 5) + hash + (guchar) name->str[i];
+    }
+
+    return hash;
+}
+
+static gboolean config_equalName(gconstpointer a, gconstpointer b)
+{
+    const ConfigName *nameA = (const ConfigName *) a;
+    const ConfigName *nameB = (const ConfigName *) b;
+
+    return nameA->len == nameB->len && 0 == memcmp(nameA->str, nameB->str, nameA->len);
+}
+
+static ConfigValue *config_refValue(ConfigValue *value)
+{
+    g_atomic_int_inc(&value->refCount);
+    return value;
+}
+
+static void config_unrefValue(gpointer data)
+{
+    ConfigValue *value = (ConfigValue *) data;
+
+    if (!g_atomic_int_dec_and_test(&value->refCount))
+        return;
+
+    g_free((gpointer) value->name.str);
+    g_free((gpointer) value->string.str);
+    j_release(&value->json);
+    g_free(value);
+}
+
+static ConfigValue *config_decodeValue(raw_buffer nameBuf, jvalue_ref valObject)
+{
+    ConfigValue *value = g_new0(ConfigValue, 1);
+    raw_buffer stringBuf;
+
+    value->refCount = 1;
+    value->name.str = g_strndup(nameBuf.m_str, nameBuf.m_len);
+    value->name.len = nameBuf.m_len;
+    // configCacheObj can share values with caller's objects
+    value->json = jvalue_duplicate(valObject);
+    value->int32Result = CONV_NOT_A_NUMBER;
+
+    if (jis_boolean(valObject))
+    {
+        value->type = ConfigValueType_Boolean;
+        jboolean_get(valObject, &value->boolean);
+    }
+    else if (jis_number(valObject))
+    {
+        value->int32Result = jnumber_get_i32(valObject, &value->int32);
+        if (CONV_OK == jnumber_get_i64(valObject, &value->integer))
+        {
+            value->type = ConfigValueType_Integer;
+            value->number = (double) value->integer;
+        }
+        else
+        {
+            value->type = ConfigValueType_Double;
+            jnumber_get_f64(valObject, &value->number);
+        }
+    }
+    else if (jis_string(valObject))
+    {
+        value->type = ConfigValueType_String;
+        stringBuf = jstring_get_fast(valObject);
+        if (stringBuf.m_str)
+        {
+            value->string.str = g_strndup(stringBuf.m_str, stringBuf.m_len);
+            value->string.len = stringBuf.m_len;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * Decode configCacheObj into values of new snapshot.
+ * Only configs in changedNames are decoded again if oldSnapshot is given.
+ * Other values are shared with oldSnapshot.
+ */
+static GHashTable *config_decodeValues(ConfigSnapshot *oldSnapshot, jvalue_ref changedNames)
+{
+    GHashTable *values = g_hash_table_new_full(config_hashName, config_equalName, NULL, config_unrefValue);
+    GHashTableIter iter;
+    gpointer key, value;
+    jobject_iter it;
+    jobject_key_value keyValPair;
+    jvalue_ref valObject = NULL;
+
+    if (!oldSnapshot || !changedNames)
+    {
+        jobject_iter_init(&it, configCacheObj);
+        while (jobject_iter_next(&it, &keyValPair))
+        {
+            ConfigValue *newValue = config_decodeValue(jstring_get_fast(keyValPair.key), keyValPair.value);
+            g_hash_table_replace(values, &newValue->name, newValue);
+        }
+
+        return values;
+    }
+
+    g_hash_table_iter_init(&iter, oldSnapshot->values);
+    while (g_hash_table_iter_next(&iter, &key, &value))
+    {
+        g_hash_table_insert(values, key, config_refValue((ConfigValue *) value));
+    }
+
+    jobject_iter_init(&it, changedNames);
+    while (jobject_iter_next(&it, &keyValPair))
+    {
+        raw_buffer nameBuf = jstring_get_fast(keyValPair.key);
+        ConfigName name = { nameBuf.m_str, nameBuf.m_len };
+
+        if (jobject_get_exists(configCacheObj, nameBuf, &valObject))
+        {
+            ConfigValue *newValue = config_decodeValue(nameBuf, valObject);
+            g_hash_table_replace(values, &newValue->name, newValue);
+        }
+        else
+        {
+            g_hash_table_remove(values, &name);
+        }
+    }
+
+    return values;
+}
+
+static ConfigValue *config_lookupValue(ConfigSnapshot *snapshot, raw_buffer configNameBuf)
+{
+    ConfigName name = { configNameBuf.m_str, configNameBuf.m_len };
+
+    if (!snapshot)
+        return NULL;
+
+    return (ConfigValue *) g_hash_table_lookup(snapshot->values, &name);
+}
+
+static ConfigValue *config_lookupHandle(ConfigSnapshot *snapshot, ConfigHandle *handle)
+{
+    raw_buffer configNameBuf = { handle->name.str, handle->name.len };
+
+    if (!snapshot)
+        return NULL;
+
+    if (handle->index < snapshot->slotCount)
+        return snapshot->slots[handle->index];
+
+    // Handle is created after the snapshot is published
+    return config_lookupValue(snapshot, configNameBuf);
+}
+
+static void config_resolveSlots(ConfigSnapshot *snapshot)
+{
+    GHashTableIter iter;
+    gpointer key, handle;
+
+    g_mutex_lock(&configHandleLock);
+
+    if (configHandles)
+    {
+        snapshot->slotCount = g_hash_table_size(configHandles);
+        snapshot->slots = g_new0(ConfigValue *, snapshot->slotCount);
+
+        g_hash_table_iter_init(&iter, configHandles);
+        while (g_hash_table_iter_next(&iter, &key, &handle))
+        {
+            snapshot->slots[((ConfigHandle *) handle)->index] = g_hash_table_lookup(snapshot->values, key);
+        }
+    }
+
+    g_mutex_unlock(&configHandleLock);
+}
+
+static void config_freeSnapshot(ConfigSnapshot *snapshot)
+{
+    if (snapshot)
+    {
+        g_free(snapshot->slots);
+        g_hash_table_destroy(snapshot->values);
+        g_free(snapshot);
+    }
+}
+
+static void config_reclaimSnapshots()
+{
+    ConfigSnapshot *retired = NULL;
+    ConfigSnapshot **link = NULL;
+    gint epoch;
+    int32_t i;
+
+    g_mutex_lock(&configRetiredLock);
+
+    // Readers of epoch - 1 share the counter with readers of epoch + 1
+    for (i = 0; i < 2; i++)
+    {
+        epoch = g_atomic_int_get(&configSnapshotEpoch);
+        if (0 != g_atomic_int_get(&configSnapshotReaders[((guint) epoch + 1) & 1]))
+            break;
+
+        g_atomic_int_set(&configSnapshotEpoch, epoch + 1);
+    }
+
+    epoch = g_atomic_int_get(&configSnapshotEpoch);
+    link = &configRetiredSnapshots;
+    while (*link)
+    {
+        ConfigSnapshot *snapshot = *link;
+
+        if ((guint) epoch - (guint) snapshot->retiredEpoch >= 2)
+        {
+            *link = snapshot->retiredNext;
+            snapshot->retiredNext = retired;
+            retired = snapshot;
+        }
+        else
+        {
+            link = &snapshot->retiredNext;
+        }
+    }
+
+    g_mutex_unlock(&configRetiredLock);
+
+    while (retired)
+    {
+        ConfigSnapshot *next = retired->retiredNext;
+        config_freeSnapshot(retired);
+        retired = next;
+    }
+}
+
+static bool config_matchKeyWatch(ConfigKeyWatch *watch, raw_buffer configNameBuf)
+{
+    if (watch->isPrefix)
+    {
+        return configNameBuf.m_len >= watch->name.len
+               && 0 == memcmp(configNameBuf.m_str, watch->name.str, watch->name.len);
+    }
+
+    return configNameBuf.m_len == watch->name.len
+           && 0 == memcmp(configNameBuf.m_str, watch->name.str, watch->name.len);
+}
+
+/**
+ * Collect changed configs from oldSnapshot to newSnapshot.
+ * Removed configs have null value.
+ * Only configs in changedNames are compared unless it is NULL.
+ *
+ * @return jobject if there is any change, otherwise NULL
+ */
+static jvalue_ref config_diffSnapshots(ConfigSnapshot *oldSnapshot, ConfigSnapshot *newSnapshot, jvalue_ref changedNames)
+{
+    jvalue_ref changedObjects = jobject_create();
+    GHashTableIter iter;
+    gpointer key, value;
+    jobject_iter it;
+    jobject_key_value keyValPair;
+
+    if (changedNames)
+    {
+        jobject_iter_init(&it, changedNames);
+        while (jobject_iter_next(&it, &keyValPair))
+        {
+            raw_buffer nameBuf = jstring_get_fast(keyValPair.key);
+            ConfigName name = { nameBuf.m_str, nameBuf.m_len };
+            ConfigValue *oldValue = oldSnapshot ? g_hash_table_lookup(oldSnapshot->values, &name) : NULL;
+            ConfigValue *newValue = newSnapshot ? g_hash_table_lookup(newSnapshot->values, &name) : NULL;
+
+            if (oldValue == newValue)
+                continue;
+
+            if (newValue && (!oldValue || !jvalue_equal(oldValue->json, newValue->json)))
+                jobject_put(changedObjects, jvalue_copy(keyValPair.key), jvalue_copy(newValue->json));
+            else if (!newValue)
+                jobject_put(changedObjects, jvalue_copy(keyValPair.key), jnull());
+        }
+    }
+    else if (newSnapshot)
+    {
+        g_hash_table_iter_init(&iter, newSnapshot->values);
+        while (g_hash_table_iter_next(&iter, &key, &value))
+        {
+            ConfigValue *newValue = (ConfigValue *) value;
+            ConfigValue *oldValue = oldSnapshot ? g_hash_table_lookup(oldSnapshot->values, key) : NULL;
+
+            if (!oldValue || !jvalue_equal(oldValue->json, newValue->json))
+            {
+                jobject_put(changedObjects, jstring_create_utf8(newValue->name.str, newValue->name.len),
+                            jvalue_copy(newValue->json));
+            }
+        }
+    }
+
+    if (!changedNames && oldSnapshot)
+    {
+        g_hash_table_iter_init(&iter, oldSnapshot->values);
+        while (g_hash_table_iter_next(&iter, &key, &value))
+        {
+            ConfigValue *oldValue = (ConfigValue *) value;
+
+            if (!newSnapshot || !g_hash_table_lookup(newSnapshot->values, key))
+            {
+                jobject_put(changedObjects, jstring_create_utf8(oldValue->name.str, oldValue->name.len), jnull());
+            }
+        }
+    }
+
+    if (0 == jobject_size(changedObjects))
+    {
+        j_release(&changedObjects);
+        return NULL;
+    }
+
+    return changedObjects;
+}
+
+static GSList *config_collectKeyNotificationsUnsafe(jvalue_ref changedObjects)
+{
+    GSList *notifications = NULL;
+    GSList *it;
+
+    for (it = configKeyWatchers; it; it = g_slist_next(it))
+    {
+        ConfigKeyWatch *watch = (ConfigKeyWatch *) it->data;
+        jvalue_ref filtered = NULL;
+        jobject_iter iter;
+        jobject_key_value keyValPair;
+
+        jobject_iter_init(&iter, changedObjects);
+        while (jobject_iter_next(&iter, &keyValPair))
+        {
+            if (!config_matchKeyWatch(watch, jstring_get_fast(keyValPair.key)))
+                continue;
+
+            if (!filtered)
+                filtered = jobject_create();
+            jobject_put(filtered, jvalue_copy(keyValPair.key), jvalue_copy(keyValPair.value));
+        }
+
+        if (filtered)
+        {
+            ConfigKeyNotification *notification = g_new0(ConfigKeyNotification, 1);
+            notification->func = watch->func;
+            notification->context = watch->context;
+            notification->changedObjects = filtered;
+            notifications = g_slist_prepend(notifications, notification);
+        }
+    }
+
+    return g_slist_reverse(notifications);
+}
+
+static void config_freeKeyNotification(gpointer data)
+{
+    ConfigKeyNotification *notification = (ConfigKeyNotification *) data;
+
+    j_release(&notification->changedObjects);
+    g_free(notification);
+}
+
+/**
+ * Call key watchers collected by config_publishSnapshotUnsafe().
+ * It must be called after configCacheLock is unlocked to let watchers call config_getXXX().
+ */
+static void config_notifyKeyWatchers(GSList *notifications)
+{
+    GSList *it;
+
+    for (it = notifications; it; it = g_slist_next(it))
+    {
+        ConfigKeyNotification *notification = (ConfigKeyNotification *) it->data;
+        notification->func(notification->changedObjects, notification->context);
+    }
+
+    g_slist_free_full(notifications, config_freeKeyNotification);
+}
+
+/**
+ * Publish configCacheObj as a new snapshot
+ *
+ * @param changedNames jobject whose keys are config names changed in configCacheObj
+ *                     since the last publish. NULL means all configs.
+ * @return notifications for key watchers whose configs are changed.
+ *         The caller must pass it to config_notifyKeyWatchers() after unlock.
+ */
+static GSList *config_publishSnapshotUnsafe(jvalue_ref changedNames)
+{
+    ConfigSnapshot *snapshot = NULL;
+    ConfigSnapshot *oldSnapshot = NULL;
+    GSList *notifications = NULL;
+
+    // Writers are serialized by configCacheLock
+    oldSnapshot = g_atomic_pointer_get(&configSnapshot);
+
+    if (!jis_null(configCacheObj))
+    {
+        snapshot = g_new0(ConfigSnapshot, 1);
+        snapshot->values = config_decodeValues(oldSnapshot, changedNames);
+        config_resolveSlots(snapshot);
+    }
+
+    g_atomic_pointer_set(&configSnapshot, snapshot);
+
+    if (configKeyWatchers)
+    {
+        jvalue_ref changedObjects = config_diffSnapshots(oldSnapshot, snapshot,
+                                                         (oldSnapshot && snapshot) ? changedNames : NULL);
+        if (changedObjects)
+        {
+            notifications = config_collectKeyNotificationsUnsafe(changedObjects);
+            j_release(&changedObjects);
+        }
+    }
+
+    if (oldSnapshot)
+    {
+        g_mutex_lock(&configRetiredLock);
+        // Readers which got oldSnapshot are in this epoch or older ones
+        oldSnapshot->retiredEpoch = g_atomic_int_get(&configSnapshotEpoch);
+        oldSnapshot->retiredNext = configRetiredSnapshots;
+        configRetiredSnapshots = oldSnapshot;
+        g_mutex_unlock(&configRetiredLock);
+    }
+
+    config_reclaimSnapshots();
+    return notifications;
+}
+
+/**
+ * usage example
+ *  {
+ *      gint readerEpoch = 0;
+ *      ConfigSnapshot *snapshot = config_acquireSnapshot(&readerEpoch);
+ *      do something with snapshot (could be NULL)
+ *      config_releaseSnapshot(readerEpoch);
+ *  }
+ */
+static ConfigSnapshot *config_acquireSnapshot(gint *readerEpoch)
+{
+    // Wait for the first reply only if nothing is loaded yet
+    if (g_atomic_int_get(&configUpdateWaitingLsCount) && !g_atomic_pointer_get(&configSnapshot))
+    {
+        CONFIG_COND_WAIT(&configCacheCond, &configCacheLock);
+        g_mutex_unlock(&configCacheLock);
+    }
+
+    // Retry if the epoch is advanced before this reader is counted
+    while (true)
+    {
+        *readerEpoch = g_atomic_int_get(&configSnapshotEpoch);
+        g_atomic_int_inc(&configSnapshotReaders[(guint) *readerEpoch & 1]);
+
+        if (g_atomic_int_get(&configSnapshotEpoch) == *readerEpoch)
+            break;
+
+        g_atomic_int_add(&configSnapshotReaders[(guint) *readerEpoch & 1], -1);
+    }
+
+    return g_atomic_pointer_get(&configSnapshot);
+}
+
+/**
+ * Load requested configs from the image published by configd without waiting for
+ * the first getConfigs reply. The reply updates them later as usual.
+ */
+static GSList *config_loadSharedSnapshotUnsafe(jvalue_ref configNames)
+{
+    jvalue_ref configs = jobject_create();
+    jobject_iter it;
+    jobject_key_value keyValPair;
+
+    if (!config_readSharedSnapshot(SNAPSHOT_SHARED_PATH, configNames, configs, &configSharedGeneration))
+    {
+        j_release(&configs);
+        return NULL;
+    }
+
+    LOG_LIB_INFO_PAIRS(MSGID_LIBCONFIGD, 0, "%d configs are loaded from shared snapshot (generation %" G_GUINT64_FORMAT ")",
+                       jobject_size(configs), configSharedGeneration);
+
+    if (NULL == configCacheObj)
+    {
+        configCacheObj = configs;
+        return config_publishSnapshotUnsafe(NULL);
+    }
+
+    jobject_iter_init(&it, configs);
+    while (jobject_iter_next(&it, &keyValPair))
+    {
+        jobject_put(configCacheObj, jvalue_copy(keyValPair.key), jvalue_copy(keyValPair.value));
+    }
+
+    GSList *notifications = config_publishSnapshotUnsafe(configs);
+    j_release(&configs);
+    return notifications;
+}
+
+static void config_releaseSnapshot(gint readerEpoch)
+{
+    if (g_atomic_int_dec_and_test(&configSnapshotReaders[(guint) readerEpoch & 1])
+        && g_atomic_pointer_get(&configRetiredSnapshots))
+    {
+        config_reclaimSnapshots();
+    }
+}
+
+/**
+ * setConfigs between config_beginSetConfigs() and config_commitSetConfigs() of a thread.
+ * setConfigs of other threads are not merged into it.
+ * Configs are published in the outermost commit. Until then, only the batching thread
+ * reads them through values.
+ */
+typedef struct {
+    int32_t depth;
+    jvalue_ref request;
+    jvalue_ref configs;
+    ConfigUndoLog *undoLog;
+    GHashTable *values; // ConfigName -> ConfigValue decoded from configs
+} ConfigBatch;
+
+static void config_freeBatch(gpointer data);
+static GPrivate configBatch = G_PRIVATE_INIT(config_freeBatch);
+
+/**
+ * Acquire the current snapshot and look up a config by handle or by name.
+ * Configs set in the batch of this thread are found first.
+ * Shared snapshot doesn't have read-protected configs. So if the config is not found
+ * while getConfigs replies are pending, it waits for them as before the image is loaded.
+ * The caller must release the snapshot.
+ */
+static ConfigValue *config_acquireValue(raw_buffer configNameBuf, ConfigHandle *handle,
+                                        ConfigSnapshot **snapshot, gint *readerEpoch)
+{
+    ConfigBatch *batch = (ConfigBatch *) g_private_get(&configBatch);
+    ConfigName name = { configNameBuf.m_str, configNameBuf.m_len };
+    ConfigValue *value = NULL;
+
+    *snapshot = config_acquireSnapshot(readerEpoch);
+    if (batch && batch->depth > 0 && (value = g_hash_table_lookup(batch->values, &name)))
+        return value;
+
+    value = handle ? config_lookupHandle(*snapshot, handle) : config_lookupValue(*snapshot, configNameBuf);
+    if (value || !g_atomic_int_get(&configUpdateWaitingLsCount))
+        return value;
+
+    config_releaseSnapshot(*readerEpoch);
+    CONFIG_COND_WAIT(&configCacheCond, &configCacheLock);
+    g_mutex_unlock(&configCacheLock);
+
+    *snapshot = config_acquireSnapshot(readerEpoch);
+    return handle ? config_lookupHandle(*snapshot, handle) : config_lookupValue(*snapshot, configNameBuf);
+}
+
+static ConfigUndoLog *config_createUndoLog()
+{
+    ConfigUndoLog *undoLog = g_new0(ConfigUndoLog, 1);
+
+    undoLog->oldValues = jobject_create();
+    undoLog->addedKeys = jobject_create();
+    return undoLog;
+}
+
+static void config_freeUndoLog(ConfigUndoLog *undoLog)
+{
+    if (undoLog)
+    {
+        j_release(&undoLog->oldValues);
+        j_release(&undoLog->addedKeys);
+        g_free(undoLog);
+    }
+}
+
+/**
+ * Update configCacheObj with configs and record previous values into undoLog.
+ * Only the first previous value is recorded if the same config is updated again.
+ */
+static void config_applyConfigsUnsafe(jvalue_ref configs, ConfigUndoLog *undoLog)
+{
+    jobject_iter it;
+    jobject_key_value keyValPair;
+    jvalue_ref oldValue = NULL;
+
+    jobject_iter_init(&it, configs);
+    while (jobject_iter_next(&it, &keyValPair))
+    {
+        raw_buffer jKeyBuf = jstring_get_fast(keyValPair.key);
+
+        if (jis_null(keyValPair.value)) continue;
+
+        if (!jobject_containskey2(undoLog->oldValues, keyValPair.key)
+            && !jobject_containskey2(undoLog->addedKeys, keyValPair.key))
+        {
+            if (jobject_get_exists(configCacheObj, jKeyBuf, &oldValue))
+                jobject_put(undoLog->oldValues, jvalue_copy(keyValPair.key), jvalue_copy(oldValue));
+            else
+                jobject_put(undoLog->addedKeys, jvalue_copy(keyValPair.key), jboolean_create(true));
+        }
+
+        if (jobject_containskey2(configCacheObj, keyValPair.key))
+        {
+            jobject_remove(configCacheObj, jKeyBuf);
+        }
+
+        jobject_put(configCacheObj, jvalue_copy(keyValPair.key), jvalue_copy(keyValPair.value));
+    }
+}
+
+/**
+ * Restore configCacheObj from undoLog
+ *
+ * @return jobject whose keys are restored config names. The caller must release it.
+ */
+static jvalue_ref config_undoUnsafe(ConfigUndoLog *undoLog)
+{
+    jvalue_ref restoredNames = jobject_create();
+    jobject_iter it;
+    jobject_key_value keyValPair;
+
+    if (!undoLog || jis_null(configCacheObj))
+        return restoredNames;
+
+    jobject_iter_init(&it, undoLog->addedKeys);
+    while (jobject_iter_next(&it, &keyValPair))
+    {
+        jobject_remove(configCacheObj, jstring_get_fast(keyValPair.key));
+        jobject_put(restoredNames, jvalue_copy(keyValPair.key), jnull());
+    }
+
+    jobject_iter_init(&it, undoLog->oldValues);
+    while (jobject_iter_next(&it, &keyValPair))
+    {
+        jobject_put(configCacheObj, jvalue_copy(keyValPair.key), jvalue_copy(keyValPair.value));
+        jobject_put(restoredNames, jvalue_copy(keyValPair.key), jnull());
+    }
+
+    return restoredNames;
+}
 
 static bool config_setLSHandle(LSHandle *lsHandle)
 {
@@ -92,6 +842,8 @@ static bool config_cbWatchConfigs(LSHandle *lsHandle, LSMessage *message, void *
     jvalue_ref configsObj = NULL; // No ownership
     jvalue_ref missingConfigsObj = NULL; // No ownership
     jvalue_ref queryObject = (jvalue_ref) userData;
+    jvalue_ref changedNames = NULL;
+    GSList *notifications = NULL;
 
     g_mutex_lock(&configCacheLock);
 
@@ -112,7 +864,7 @@ static bool config_cbWatchConfigs(LSHandle *lsHandle, LSMessage *message, void *
 
     jschema_info_init(&schemaInfo, jschema_all(), NULL, NULL);
     replyObj = jdom_parse(j_cstr_to_buffer(LSMessageGetPayload(message)), DOMOPT_NOOPT, &schemaInfo);
-
+    changedNames = jobject_create();
 
     if (jobject_get_exists(replyObj, J_CSTR_TO_BUF("configs"), &configsObj))
     {
@@ -131,6 +883,7 @@ static bool config_cbWatchConfigs(LSHandle *lsHandle, LSMessage *message, void *
             while (jobject_iter_next(&it, &keyValPair))
             {
                 jobject_put(configCacheObj, jvalue_copy(keyValPair.key), jvalue_copy(keyValPair.value));
+                jobject_put(changedNames, jvalue_copy(keyValPair.key), jnull());
             }
         }
     }
@@ -148,16 +901,19 @@ static bool config_cbWatchConfigs(LSHandle *lsHandle, LSMessage *message, void *
             if (missingConfigBuf.m_str)
             {
                 jobject_remove(configCacheObj, missingConfigBuf);
+                jobject_put(changedNames, jstring_create_utf8(missingConfigBuf.m_str, missingConfigBuf.m_len), jnull());
                 jstring_free_buffer(missingConfigBuf);
             }
         }
     }
 
     config_evaluateMissingConfigsSafe();
+    notifications = config_publishSnapshotUnsafe(changedNames);
+    j_release(&changedNames);
 
     if (configUpdateWaitingLsCount)
     {
-        --configUpdateWaitingLsCount;
+        g_atomic_int_add(&configUpdateWaitingLsCount, -1);
     }
 
     // wake up all pending clients
@@ -166,6 +922,7 @@ static bool config_cbWatchConfigs(LSHandle *lsHandle, LSMessage *message, void *
 
     // notify to all watchers
     // To let callback functions to call config_getXXX(), it's important to unlock first.
+    config_notifyKeyWatchers(notifications);
     if (configWatchers)
     {
         GHashTableIter iter;
@@ -191,7 +948,8 @@ static bool config_cbSetConfigs(LSHandle *lsHandle, LSMessage *message, void *us
     jvalue_ref replyObj = NULL;
     jvalue_ref resultObj = NULL;
     bool result = false;
-    jvalue_ref backupConfigObj = (jvalue_ref) userData;
+    ConfigUndoLog *undoLog = (ConfigUndoLog *) userData;
+    GSList *notifications = NULL;
 
     g_mutex_lock(&configCacheLock);
 
@@ -210,22 +968,22 @@ static bool config_cbSetConfigs(LSHandle *lsHandle, LSMessage *message, void *us
     if (result)
     {
         LOG_LIB_INFO_PAIRS(MSGID_LIBCONFIGD, 0, "setConfigs is requested successfully");
-        j_release(&backupConfigObj);
     }
     else
     {
         LOG_LIB_INFO_PAIRS(MSGID_LIBCONFIGD, 0, "setConfigs request is failed");
 
-        if (!jis_null(backupConfigObj))
-        {
-            j_release(&configCacheObj);
-            configCacheObj = backupConfigObj;
-        }
+        jvalue_ref restoredNames = config_undoUnsafe(undoLog);
+        notifications = config_publishSnapshotUnsafe(restoredNames);
+        j_release(&restoredNames);
     }
+    config_freeUndoLog(undoLog);
 
     j_release(&replyObj);
     g_mutex_unlock(&configCacheLock);
 
+    config_notifyKeyWatchers(notifications);
+
     return result;
 }
 
@@ -268,6 +1026,7 @@ bool config_loadConfigs(LSHandle *lsHandle, char *configNames[], int32_t *errorC
     jvalue_ref jArrayConfigNames = NULL;
     jvalue_ref queryObject = NULL;
     bool retVal = false;
+    GSList *notifications = NULL;
 
     PmLogGetContext("libconfigd", &confdLibContext);
 
@@ -316,6 +1075,8 @@ bool config_loadConfigs(LSHandle *lsHandle, char *configNames[], int32_t *errorC
     jobject_put(queryObject, jstring_create("configNames"), jArrayConfigNames);
     jobject_put(queryObject, jstring_create("subscribe"), jboolean_create(true));
 
+    notifications = config_loadSharedSnapshotUnsafe(jArrayConfigNames);
+
     if ((retVal = configd_getConfigsUnsafe(config_getLSHandle(), jvalue_duplicate(queryObject), errorCode)))
     {
         configQueryNames = jvalue_duplicate(jArrayConfigNames);
@@ -324,6 +1085,8 @@ bool config_loadConfigs(LSHandle *lsHandle, char *configNames[], int32_t *errorC
     j_release(&queryObject);
     g_mutex_unlock(&configCacheLock);
 
+    config_notifyKeyWatchers(notifications);
+
     return retVal;
 }
 
@@ -332,7 +1095,7 @@ static bool configd_getConfigsUnsafe(LSHandle *lsHandle, jvalue_ref queryObject,
     if (LSCall(lsHandle, GETCONFIGS_METHOD, jvalue_tostring_simple(queryObject), config_cbWatchConfigs, queryObject, NULL,
                NULL))
     {
-        configUpdateWaitingLsCount++;
+        g_atomic_int_inc(&configUpdateWaitingLsCount);
 
         if (!LSCall(config_getLSHandle(), "palm://com.palm.bus/signal/addmatch",
                 "{\"category\":\"/com/webos/config\", \"method\":\"reloadDone\"}",
@@ -425,6 +1188,63 @@ void config_addWatch(configdNotify func, void *watch_context)
     g_mutex_unlock(&configCacheLock);
 }
 
+bool config_addKeyWatch(raw_buffer configNameBuf, configdNotify func, void *watch_context)
+{
+    ConfigKeyWatch *watch = NULL;
+
+    if (!configNameBuf.m_str || 0 == configNameBuf.m_len || !func)
+        return false;
+
+    watch = g_new0(ConfigKeyWatch, 1);
+    watch->isPrefix = (configNameBuf.m_str[configNameBuf.m_len - 1] == CONFIG_WILDCARD);
+    watch->name.len = watch->isPrefix ? configNameBuf.m_len - 1 : configNameBuf.m_len;
+    watch->name.str = g_strndup(configNameBuf.m_str, watch->name.len);
+    watch->func = func;
+    watch->context = watch_context;
+
+    g_mutex_lock(&configCacheLock);
+    configKeyWatchers = g_slist_append(configKeyWatchers, watch);
+    g_mutex_unlock(&configCacheLock);
+
+    return true;
+}
+
+bool config_removeKeyWatch(raw_buffer configNameBuf, configdNotify func)
+{
+    bool retVal = false;
+    bool isPrefix = false;
+    GSList *it;
+
+    if (!configNameBuf.m_str || 0 == configNameBuf.m_len)
+        return false;
+
+    isPrefix = (configNameBuf.m_str[configNameBuf.m_len - 1] == CONFIG_WILDCARD);
+    if (isPrefix)
+        configNameBuf.m_len--;
+
+    g_mutex_lock(&configCacheLock);
+
+    for (it = configKeyWatchers; it; it = g_slist_next(it))
+    {
+        ConfigKeyWatch *watch = (ConfigKeyWatch *) it->data;
+
+        if (watch->func == func
+            && watch->isPrefix == isPrefix
+            && watch->name.len == configNameBuf.m_len
+            && 0 == memcmp(watch->name.str, configNameBuf.m_str, watch->name.len))
+        {
+            configKeyWatchers = g_slist_delete_link(configKeyWatchers, it);
+            g_free((gpointer) watch->name.str);
+            g_free(watch);
+            retVal = true;
+            break;
+        }
+    }
+
+    g_mutex_unlock(&configCacheLock);
+    return retVal;
+}
+
 bool config_removeWatch(configdNotify func)
 {
     bool retVal = false;
@@ -458,15 +1278,25 @@ jvalue_ref config_getReqConfigNamesArray()
 jvalue_ref config_getAllConfigs()
 {
     jvalue_ref allConfigs = jnull();
+    gint readerEpoch = 0;
+    ConfigSnapshot *snapshot = config_acquireSnapshot(&readerEpoch);
 
-    CONFIG_COND_WAIT(&configCacheCond, &configCacheLock);
-
-    if (configCacheObj && jis_valid(configCacheObj) && jis_object(configCacheObj))
+    if (snapshot)
     {
-        allConfigs = jvalue_duplicate(configCacheObj);
+        GHashTableIter iter;
+        gpointer key, value;
+
+        allConfigs = jobject_create();
+        g_hash_table_iter_init(&iter, snapshot->values);
+        while (g_hash_table_iter_next(&iter, &key, &value))
+        {
+            ConfigValue *configValue = (ConfigValue *) value;
+            jobject_put(allConfigs, jstring_create_utf8(configValue->name.str, configValue->name.len),
+                        jvalue_duplicate(configValue->json));
+        }
     }
 
-    g_mutex_unlock(&configCacheLock);
+    config_releaseSnapshot(readerEpoch);
 
     return allConfigs;
 }
@@ -577,68 +1407,89 @@ bool config_waitReLoadConfigs(int64_t timeoutMilli)
             retVal = false;
             break;
         }
-    }
+    }
+
+    g_mutex_unlock(&configCacheLock);
+
+    return retVal;
+}
+
+static bool config_readBoolean(ConfigSnapshot *snapshot, ConfigValue *value, int32_t *pData, int32_t *errorCode)
+{
+    if (!snapshot)
+    {
+        if (errorCode)
+        {
+            //Config_loadConfig not called
+            *errorCode = CONFIG_MODULE_NOT_INITIALIZED;
+        }
 
-    g_mutex_unlock(&configCacheLock);
+        return false;
+    }
 
-    return retVal;
-}
+    if (!value)
+    {
+        if (errorCode)
+        {
+            *errorCode = CONFIG_VALUE_NOT_FOUND;
+        }
 
-bool config_getBoolean(raw_buffer configNameBuf, int32_t *pData, int32_t *errorCode)
-{
-    bool bConfigVal = false;
-    jvalue_ref valObject = NULL;
+        return false;
+    }
 
-    if (!configNameBuf.m_str || !pData)
+    if (ConfigValueType_Boolean != value->type)
     {
         if (errorCode)
         {
-            *errorCode = CONFIG_INVALID_ARGUMENTS;
+            *errorCode = CONFIG_DATA_TYPE_MISMATCH;
         }
 
         return false;
     }
 
-    CONFIG_COND_WAIT(&configCacheCond, &configCacheLock);
+    *pData = value->boolean;
+
+    if (errorCode)
+    {
+        *errorCode = CONFIG_NO_ERROR;
+    }
 
-    if (!configCacheObj)
+    return true;
+}
+
+static bool config_readInteger(ConfigSnapshot *snapshot, ConfigValue *value, int32_t *pData, int32_t *errorCode)
+{
+    if (!snapshot)
     {
         if (errorCode)
         {
-            //Config_loadConfig not called
             *errorCode = CONFIG_MODULE_NOT_INITIALIZED;
         }
 
-        g_mutex_unlock(&configCacheLock);
         return false;
     }
 
-    if (!(jobject_get_exists(configCacheObj, configNameBuf, &valObject)))
+    if (!value)
     {
         if (errorCode)
         {
             *errorCode = CONFIG_VALUE_NOT_FOUND;
         }
 
-        g_mutex_unlock(&configCacheLock);
         return false;
     }
 
-    if (CONV_NOT_A_BOOLEAN == jboolean_get(valObject, &bConfigVal))
+    if (CONV_OK != value->int32Result)
     {
         if (errorCode)
         {
             *errorCode = CONFIG_DATA_TYPE_MISMATCH;
         }
 
-        g_mutex_unlock(&configCacheLock);
         return false;
     }
 
-    g_mutex_unlock(&configCacheLock);
-
-    //Assuming jboolen_get will return actual config value
-    *pData = bConfigVal;
+    *pData = value->int32;
 
     if (errorCode)
     {
@@ -648,56 +1499,74 @@ bool config_getBoolean(raw_buffer configNameBuf, int32_t *pData, int32_t *errorC
     return true;
 }
 
-bool config_getInteger(raw_buffer configNameBuf, int32_t *pData, int32_t *errorCode)
+static bool config_readStringDup(ConfigSnapshot *snapshot, ConfigValue *value, raw_buffer *pData, int32_t *errorCode)
 {
-    jvalue_ref valObject = NULL;
-
-    if (!configNameBuf.m_str || !pData)
+    if (!snapshot)
     {
         if (errorCode)
         {
-            *errorCode = CONFIG_INVALID_ARGUMENTS;
+            *errorCode = CONFIG_MODULE_NOT_INITIALIZED;
         }
 
         return false;
     }
 
-    CONFIG_COND_WAIT(&configCacheCond, &configCacheLock);
+    // Caller releases it with jstring_free_buffer()
+    pData->m_str = NULL;
+    pData->m_len = 0;
+    if (value && ConfigValueType_String == value->type && value->string.str)
+    {
+        char *str = (char *) malloc(value->string.len + 1);
+        if (str)
+        {
+            memcpy(str, value->string.str, value->string.len);
+            str[value->string.len] = '\0';
+            pData->m_str = str;
+            pData->m_len = value->string.len;
+        }
+    }
 
-    if (!configCacheObj)
+    if (NULL == pData->m_str)
     {
         if (errorCode)
         {
-            *errorCode = CONFIG_MODULE_NOT_INITIALIZED;
+            *errorCode = CONFIG_VALUE_NOT_FOUND;
         }
 
-        g_mutex_unlock(&configCacheLock);
         return false;
     }
 
-    if (!(jobject_get_exists(configCacheObj, configNameBuf, &valObject)))
+    if (errorCode)
+    {
+        *errorCode = CONFIG_NO_ERROR;
+    }
+
+    return true;
+}
+
+static bool config_readJsonObject(ConfigSnapshot *snapshot, ConfigValue *value, jvalue_ref *pData, int32_t *errorCode)
+{
+    if (!snapshot)
     {
         if (errorCode)
         {
-            *errorCode = CONFIG_VALUE_NOT_FOUND;
+            *errorCode = CONFIG_MODULE_NOT_INITIALIZED;
         }
 
-        g_mutex_unlock(&configCacheLock);
         return false;
     }
 
-    if (CONV_OK != jnumber_get_i32(valObject, pData))
+    if (!value)
     {
         if (errorCode)
         {
-            *errorCode = CONFIG_DATA_TYPE_MISMATCH;
+            *errorCode = CONFIG_VALUE_NOT_FOUND;
         }
 
-        g_mutex_unlock(&configCacheLock);
         return false;
     }
 
-    g_mutex_unlock(&configCacheLock);
+    *pData = jvalue_duplicate(value->json);
 
     if (errorCode)
     {
@@ -707,9 +1576,9 @@ bool config_getInteger(raw_buffer configNameBuf, int32_t *pData, int32_t *errorC
     return true;
 }
 
-bool config_getStringDup(raw_buffer configNameBuf, raw_buffer *pData, int32_t *errorCode)
+bool config_getBoolean(raw_buffer configNameBuf, int32_t *pData, int32_t *errorCode)
 {
-    jvalue_ref valObject = NULL;
+    bool retVal = false;
 
     if (!configNameBuf.m_str || !pData)
     {
@@ -721,57 +1590,132 @@ bool config_getStringDup(raw_buffer configNameBuf, raw_buffer *pData, int32_t *e
         return false;
     }
 
+    gint readerEpoch = 0;
+    ConfigSnapshot *snapshot = NULL;
+    ConfigValue *value = config_acquireValue(configNameBuf, NULL, &snapshot, &readerEpoch);
+    retVal = config_readBoolean(snapshot, value, pData, errorCode);
+    config_releaseSnapshot(readerEpoch);
 
-    CONFIG_COND_WAIT(&configCacheCond, &configCacheLock);
+    return retVal;
+}
+
+bool config_getInteger(raw_buffer configNameBuf, int32_t *pData, int32_t *errorCode)
+{
+    bool retVal = false;
 
-    if (!configCacheObj)
+    if (!configNameBuf.m_str || !pData)
     {
         if (errorCode)
         {
-            *errorCode = CONFIG_MODULE_NOT_INITIALIZED;
+            *errorCode = CONFIG_INVALID_ARGUMENTS;
         }
 
-        g_mutex_unlock(&configCacheLock);
         return false;
     }
 
-    if (!(jobject_get_exists(configCacheObj, configNameBuf, &valObject)))
+    gint readerEpoch = 0;
+    ConfigSnapshot *snapshot = NULL;
+    ConfigValue *value = config_acquireValue(configNameBuf, NULL, &snapshot, &readerEpoch);
+    retVal = config_readInteger(snapshot, value, pData, errorCode);
+    config_releaseSnapshot(readerEpoch);
+
+    return retVal;
+}
+
+bool config_getStringDup(raw_buffer configNameBuf, raw_buffer *pData, int32_t *errorCode)
+{
+    bool retVal = false;
+
+    if (!configNameBuf.m_str || !pData)
     {
         if (errorCode)
         {
-            *errorCode = CONFIG_VALUE_NOT_FOUND;
+            *errorCode = CONFIG_INVALID_ARGUMENTS;
         }
 
-        g_mutex_unlock(&configCacheLock);
         return false;
     }
 
-    *pData = jstring_get(valObject);
-    g_mutex_unlock(&configCacheLock);
+    gint readerEpoch = 0;
+    ConfigSnapshot *snapshot = NULL;
+    ConfigValue *value = config_acquireValue(configNameBuf, NULL, &snapshot, &readerEpoch);
+    retVal = config_readStringDup(snapshot, value, pData, errorCode);
+    config_releaseSnapshot(readerEpoch);
 
-    if (NULL == pData->m_str)
+    return retVal;
+}
+
+bool config_getJsonObject(raw_buffer configNameBuf, jvalue_ref *pData, int32_t *errorCode)
+{
+    bool retVal = false;
+
+    if (!configNameBuf.m_str || !pData)
     {
         if (errorCode)
         {
-            *errorCode = CONFIG_VALUE_NOT_FOUND;
+            *errorCode = CONFIG_INVALID_ARGUMENTS;
         }
 
         return false;
     }
 
+    gint readerEpoch = 0;
+    ConfigSnapshot *snapshot = NULL;
+    ConfigValue *value = config_acquireValue(configNameBuf, NULL, &snapshot, &readerEpoch);
+    retVal = config_readJsonObject(snapshot, value, pData, errorCode);
+    config_releaseSnapshot(readerEpoch);
+
+    return retVal;
+}
+
+config_handle_t config_getHandle(raw_buffer configNameBuf, int32_t *errorCode)
+{
+    ConfigName name = { configNameBuf.m_str, configNameBuf.m_len };
+    ConfigHandle *handle = NULL;
+
+    if (!configNameBuf.m_str)
+    {
+        if (errorCode)
+        {
+            *errorCode = CONFIG_INVALID_ARGUMENTS;
+        }
+
+        return NULL;
+    }
+
+    g_mutex_lock(&configHandleLock);
+
+    if (!configHandles)
+    {
+        configHandles = g_hash_table_new(config_hashName, config_equalName);
+    }
+
+    handle = (ConfigHandle *) g_hash_table_lookup(configHandles, &name);
+    if (!handle)
+    {
+        // Handles are never freed, so they stay valid until process exit
+        handle = g_new0(ConfigHandle, 1);
+        handle->name.str = g_strndup(configNameBuf.m_str, configNameBuf.m_len);
+        handle->name.len = configNameBuf.m_len;
+        handle->index = g_hash_table_size(configHandles);
+        g_hash_table_insert(configHandles, &handle->name, handle);
+    }
+
+    g_mutex_unlock(&configHandleLock);
+
     if (errorCode)
     {
         *errorCode = CONFIG_NO_ERROR;
     }
 
-    return true;
+    return handle;
 }
 
-bool config_getJsonObject(raw_buffer configNameBuf, jvalue_ref *pData, int32_t *errorCode)
+bool config_getBooleanByHandle(config_handle_t handle, int32_t *pData, int32_t *errorCode)
 {
-    jvalue_ref valObject = NULL;
+    bool retVal = false;
 
-    if (!configNameBuf.m_str || !pData)
+    if (!handle || !pData)
     {
         if (errorCode)
         {
@@ -781,39 +1725,86 @@ bool config_getJsonObject(raw_buffer configNameBuf, jvalue_ref *pData, int32_t *
         return false;
     }
 
-    CONFIG_COND_WAIT(&configCacheCond, &configCacheLock);
+    raw_buffer configNameBuf = { handle->name.str, handle->name.len };
+    gint readerEpoch = 0;
+    ConfigSnapshot *snapshot = NULL;
+    ConfigValue *value = config_acquireValue(configNameBuf, handle, &snapshot, &readerEpoch);
+    retVal = config_readBoolean(snapshot, value, pData, errorCode);
+    config_releaseSnapshot(readerEpoch);
 
-    if (!configCacheObj)
+    return retVal;
+}
+
+bool config_getIntegerByHandle(config_handle_t handle, int32_t *pData, int32_t *errorCode)
+{
+    bool retVal = false;
+
+    if (!handle || !pData)
     {
         if (errorCode)
         {
-            *errorCode = CONFIG_MODULE_NOT_INITIALIZED;
+            *errorCode = CONFIG_INVALID_ARGUMENTS;
         }
 
-        g_mutex_unlock(&configCacheLock);
         return false;
     }
 
-    if (!(jobject_get_exists(configCacheObj, configNameBuf, &valObject)))
+    raw_buffer configNameBuf = { handle->name.str, handle->name.len };
+    gint readerEpoch = 0;
+    ConfigSnapshot *snapshot = NULL;
+    ConfigValue *value = config_acquireValue(configNameBuf, handle, &snapshot, &readerEpoch);
+    retVal = config_readInteger(snapshot, value, pData, errorCode);
+    config_releaseSnapshot(readerEpoch);
+
+    return retVal;
+}
+
+bool config_getStringDupByHandle(config_handle_t handle, raw_buffer *pData, int32_t *errorCode)
+{
+    bool retVal = false;
+
+    if (!handle || !pData)
     {
         if (errorCode)
         {
-            *errorCode = CONFIG_VALUE_NOT_FOUND;
+            *errorCode = CONFIG_INVALID_ARGUMENTS;
         }
 
-        g_mutex_unlock(&configCacheLock);
         return false;
     }
 
-    *pData = jvalue_duplicate(valObject);
-    g_mutex_unlock(&configCacheLock);
+    raw_buffer configNameBuf = { handle->name.str, handle->name.len };
+    gint readerEpoch = 0;
+    ConfigSnapshot *snapshot = NULL;
+    ConfigValue *value = config_acquireValue(configNameBuf, handle, &snapshot, &readerEpoch);
+    retVal = config_readStringDup(snapshot, value, pData, errorCode);
+    config_releaseSnapshot(readerEpoch);
 
-    if (errorCode)
+    return retVal;
+}
+
+bool config_getJsonObjectByHandle(config_handle_t handle, jvalue_ref *pData, int32_t *errorCode)
+{
+    bool retVal = false;
+
+    if (!handle || !pData)
     {
-        *errorCode = CONFIG_NO_ERROR;
+        if (errorCode)
+        {
+            *errorCode = CONFIG_INVALID_ARGUMENTS;
+        }
+
+        return false;
     }
 
-    return true;
+    raw_buffer configNameBuf = { handle->name.str, handle->name.len };
+    gint readerEpoch = 0;
+    ConfigSnapshot *snapshot = NULL;
+    ConfigValue *value = config_acquireValue(configNameBuf, handle, &snapshot, &readerEpoch);
+    retVal = config_readJsonObject(snapshot, value, pData, errorCode);
+    config_releaseSnapshot(readerEpoch);
+
+    return retVal;
 }
 
 bool config_setConfigs(jvalue_ref configsObj, int32_t *errorCode)
@@ -847,49 +1838,188 @@ bool config_setConfigs(jvalue_ref configsObj, int32_t *errorCode)
         return false;
     }
 
-    CONFIG_COND_WAIT(&configCacheCond, &configCacheLock);
-
-    // Restore old configCacheObj in case error
-    // free it on callback or error case
-    jvalue_ref backupConfigObj = NULL;
+    ConfigBatch *batch = (ConfigBatch *) g_private_get(&configBatch);
 
-    if (!jis_null(configCacheObj))
-    {
-        LOG_LIB_INFO_PAIRS(MSGID_LIBCONFIGD, 0, "%s: Copy configCacheObj for backup", __FUNCTION__);
-        backupConfigObj = jvalue_duplicate(configCacheObj);
-    }
+    CONFIG_COND_WAIT(&configCacheCond, &configCacheLock);
 
-    while (jobject_iter_next(&it, &keyValPair))
+    if (batch && batch->depth > 0)
     {
-        if (jis_null(keyValPair.value)) continue;
+        // Merged into one request in config_commitSetConfigs()
+        config_applyConfigsUnsafe(configsValObj, batch->undoLog);
 
-        if (jobject_containskey2(configCacheObj, keyValPair.key))
+        while (jobject_iter_next(&it, &keyValPair))
         {
-            raw_buffer jKeyBuf = jstring_get(keyValPair.key);
+            jobject_put(batch->configs, jvalue_copy(keyValPair.key), jvalue_copy(keyValPair.value));
 
-            jobject_remove(configCacheObj, jKeyBuf);
+            // Null values are not applied to configCacheObj either
+            if (jis_null(keyValPair.value))
+                continue;
+
+            ConfigValue *value = config_decodeValue(jstring_get_fast(keyValPair.key), keyValPair.value);
+            g_hash_table_replace(batch->values, &value->name, value);
         }
 
-        jobject_put(configCacheObj, jvalue_copy(keyValPair.key), jvalue_copy(keyValPair.value));
+        jobject_iter_init(&it, configsObj);
+        while (jobject_iter_next(&it, &keyValPair))
+        {
+            if (!jstring_equal2(keyValPair.key, J_CSTR_TO_BUF("configs")))
+                jobject_put(batch->request, jvalue_copy(keyValPair.key), jvalue_copy(keyValPair.value));
+        }
+
+        // Published once in the outermost config_commitSetConfigs()
+        g_mutex_unlock(&configCacheLock);
+        return true;
     }
 
+    // Restore changed configs in case error
+    // free it on callback or error case
+    ConfigUndoLog *undoLog = config_createUndoLog();
+
+    config_applyConfigsUnsafe(configsValObj, undoLog);
+    GSList *notifications = config_publishSnapshotUnsafe(configsValObj);
+
     if (!LSCallOneReply(lsHandle, SETCONFIGS_METHOD, jvalue_tostring_simple(configsObj),
-            config_cbSetConfigs, backupConfigObj, NULL, NULL))
+            config_cbSetConfigs, undoLog, NULL, NULL))
     {
         if (NULL != errorCode)
             *errorCode = CONFIG_LSCALL_FAILURE;
 
-        j_release(&configCacheObj);
-        configCacheObj = backupConfigObj;
+        jvalue_ref restoredNames = config_undoUnsafe(undoLog);
+        config_freeUndoLog(undoLog);
+
+        // Nothing is changed in the end
+        g_slist_free_full(notifications, config_freeKeyNotification);
+        g_slist_free_full(config_publishSnapshotUnsafe(restoredNames), config_freeKeyNotification);
+        j_release(&restoredNames);
 
         g_mutex_unlock(&configCacheLock);
         return false;
     }
 
     g_mutex_unlock(&configCacheLock);
+
+    config_notifyKeyWatchers(notifications);
+    return true;
+}
+
+static void config_freeBatch(gpointer data)
+{
+    ConfigBatch *batch = (ConfigBatch *) data;
+    GSList *notifications = NULL;
+
+    if (batch->depth > 0)
+    {
+        // Thread exited without commit. Nothing is sent, so nothing is changed.
+        g_mutex_lock(&configCacheLock);
+        jvalue_ref restoredNames = config_undoUnsafe(batch->undoLog);
+        notifications = config_publishSnapshotUnsafe(restoredNames);
+        j_release(&restoredNames);
+        g_mutex_unlock(&configCacheLock);
+    }
+    g_slist_free_full(notifications, config_freeKeyNotification);
+
+    j_release(&batch->request);
+    j_release(&batch->configs);
+    config_freeUndoLog(batch->undoLog);
+    g_hash_table_destroy(batch->values);
+    g_free(batch);
+}
+
+bool config_beginSetConfigs(int32_t *errorCode)
+{
+    ConfigBatch *batch = (ConfigBatch *) g_private_get(&configBatch);
+
+    if (!batch)
+    {
+        batch = g_new0(ConfigBatch, 1);
+        batch->values = g_hash_table_new_full(config_hashName, config_equalName, NULL, config_unrefValue);
+        g_private_set(&configBatch, batch);
+    }
+
+    if (0 == batch->depth++)
+    {
+        batch->request = jobject_create();
+        batch->configs = jobject_create();
+        batch->undoLog = config_createUndoLog();
+    }
+
+    if (NULL != errorCode)
+        *errorCode = CONFIG_NO_ERROR;
+
     return true;
 }
 
+bool config_commitSetConfigs(int32_t *errorCode)
+{
+    LSHandle *lsHandle = config_getLSHandle();
+    ConfigBatch *batch = (ConfigBatch *) g_private_get(&configBatch);
+    GSList *notifications = NULL;
+    bool retVal = true;
+
+    if (NULL != errorCode)
+        *errorCode = CONFIG_NO_ERROR;
+
+    if (!batch || batch->depth <= 0)
+    {
+        if (NULL != errorCode)
+            *errorCode = CONFIG_INVALID_ARGUMENTS;
+
+        return false;
+    }
+
+    if (--batch->depth > 0)
+    {
+        // Outer config_commitSetConfigs() will send it
+        return true;
+    }
+
+    ConfigUndoLog *undoLog = batch->undoLog;
+    jvalue_ref requestObj = batch->request;
+    jvalue_ref batchConfigs = batch->configs;
+    batch->undoLog = NULL;
+    batch->request = NULL;
+    batch->configs = NULL;
+
+    g_mutex_lock(&configCacheLock);
+
+    // Published configs are read from the snapshot from now on
+    g_hash_table_remove_all(batch->values);
+
+    if (0 == jobject_size(batchConfigs))
+    {
+        LOG_LIB_INFO_PAIRS(MSGID_LIBCONFIGD, 0, "%s: request with empty configs", __FUNCTION__);
+        j_release(&batchConfigs);
+        config_freeUndoLog(undoLog);
+    }
+    else
+    {
+        jobject_put(requestObj, jstring_create("configs"), batchConfigs);
+        notifications = config_publishSnapshotUnsafe(batchConfigs);
+
+        if ((NULL == lsHandle) || !LSCallOneReply(lsHandle, SETCONFIGS_METHOD, jvalue_tostring_simple(requestObj),
+                config_cbSetConfigs, undoLog, NULL, NULL))
+        {
+            if (NULL != errorCode)
+                *errorCode = (NULL == lsHandle) ? CONFIG_INVALID_LSHANDLER : CONFIG_LSCALL_FAILURE;
+
+            // Nothing is changed in the end
+            jvalue_ref restoredNames = config_undoUnsafe(undoLog);
+            config_freeUndoLog(undoLog);
+            g_slist_free_full(notifications, config_freeKeyNotification);
+            g_slist_free_full(config_publishSnapshotUnsafe(restoredNames), config_freeKeyNotification);
+            notifications = NULL;
+            j_release(&restoredNames);
+            retVal = false;
+        }
+    }
+
+    j_release(&requestObj);
+    g_mutex_unlock(&configCacheLock);
+
+    config_notifyKeyWatchers(notifications);
+    return retVal;
+}
+
 bool config_getConfigs(char *configNames[], void *cbFunc, int32_t *errorCode)
 {
     jvalue_ref jArrayConfigNames = NULL;
@@ -1076,6 +2206,7 @@ bool config_loadConfigsFromFile(char *path, char *fileName, int32_t *errorCode)
     jobject_iter it;
     jobject_key_value keyValPair;
     jobject_iter_init(&it, parseObj);
+    jvalue_ref changedNames = jobject_create();
 
     CONFIG_COND_WAIT(&configCacheCond, &configCacheLock);
 
@@ -1095,15 +2226,20 @@ bool config_loadConfigsFromFile(char *path, char *fileName, int32_t *errorCode)
             jstring_free_buffer(jKeyBuf);
         }
 
+        jobject_put(changedNames, jvalue_copy(jvalKey), jnull());
         jobject_put(configCacheObj, jvalKey, jvalue_copy(keyValPair.value));
 
         jstring_free_buffer(tempBuf);
         g_free(strKey);
     }
 
+    GSList *notifications = config_publishSnapshotUnsafe(changedNames);
     g_mutex_unlock(&configCacheLock);
+    j_release(&changedNames);
     free(category);
 
+    config_notifyKeyWatchers(notifications);
+
     // notify to all watchers
     if (configWatchers)
     {
@@ -0,0 +1,303 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <glib.h>
+
+#include "libconfigd_snapshot.h"
+#include "libconfigd.h"
+#include "Logging.h"
+#include "SnapshotFormat.h"
+
+#define SNAPSHOT_MAX_DEPTH 128
+
+typedef struct {
+    const char *base;
+    SnapshotHeader header;
+    const char *strings;
+    const char *values;
+} SharedImage;
+
+static bool snapshot_getUint32(const SharedImage *image, uint32_t *offset, uint32_t *value)
+{
+    if (*offset > image->header.valueSize || sizeof(*value) > image->header.valueSize - *offset)
+        return false;
+
+    memcpy(value, image->values + *offset, sizeof(*value));
+    *offset += sizeof(*value);
+    return true;
+}
+
+static bool snapshot_getString(const SharedImage *image, uint32_t *offset, raw_buffer *str)
+{
+    uint32_t stringOffset = 0, stringLength = 0;
+
+    if (!snapshot_getUint32(image, offset, &stringOffset) || !snapshot_getUint32(image, offset, &stringLength))
+        return false;
+
+    if (stringOffset > image->header.stringTableSize || stringLength > image->header.stringTableSize - stringOffset)
+        return false;
+
+    str->m_str = image->strings + stringOffset;
+    str->m_len = stringLength;
+    return true;
+}
+
+static jvalue_ref snapshot_decode(const SharedImage *image, uint32_t *offset, int depth)
+{
+    jvalue_ref value = NULL;
+    raw_buffer str;
+    uint32_t count = 0, i = 0;
+    uint8_t tag;
+
+    if (depth > SNAPSHOT_MAX_DEPTH || *offset >= image->header.valueSize)
+        return NULL;
+
+    tag = image->values[(*offset)++];
+    switch (tag)
+    {
+    case SnapshotValueTag_Null:
+        return jnull();
+
+    case SnapshotValueTag_False:
+    case SnapshotValueTag_True:
+        return jboolean_create(tag == SnapshotValueTag_True);
+
+    case SnapshotValueTag_Integer:
+    {
+        int64_t integer = 0;
+        if (sizeof(integer) > image->header.valueSize - *offset)
+            return NULL;
+        memcpy(&integer, image->values + *offset, sizeof(integer));
+        *offset += sizeof(integer);
+        return jnumber_create_i64(integer);
+    }
+
+    case SnapshotValueTag_Double:
+    {
+        double number = 0;
+        if (sizeof(number) > image->header.valueSize - *offset)
+            return NULL;
+        memcpy(&number, image->values + *offset, sizeof(number));
+        *offset += sizeof(number);
+        return jnumber_create_f64(number);
+    }
+
+    case SnapshotValueTag_RawNumber:
+        if (!snapshot_getString(image, offset, &str))
+            return NULL;
+        return jnumber_create(str);
+
+    case SnapshotValueTag_String:
+        if (!snapshot_getString(image, offset, &str))
+            return NULL;
+        return jstring_create_utf8(str.m_str, str.m_len);
+
+    case SnapshotValueTag_Array:
+        if (!snapshot_getUint32(image, offset, &count))
+            return NULL;
+        value = jarray_create(NULL);
+        for (i = 0; i < count; i++)
+        {
+            jvalue_ref item = snapshot_decode(image, offset, depth + 1);
+            if (!item)
+            {
+                j_release(&value);
+                return NULL;
+            }
+            jarray_append(value, item);
+        }
+        return value;
+
+    case SnapshotValueTag_Object:
+        if (!snapshot_getUint32(image, offset, &count))
+            return NULL;
+        value = jobject_create();
+        for (i = 0; i < count; i++)
+        {
+            jvalue_ref child = NULL;
+            if (!snapshot_getString(image, offset, &str) || !(child = snapshot_decode(image, offset, depth + 1)))
+            {
+                j_release(&value);
+                return NULL;
+            }
+            jobject_put(value, jstring_create_utf8(str.m_str, str.m_len), child);
+        }
+        return value;
+
+    default:
+        break;
+    }
+
+    return NULL;
+}
+
+static bool snapshot_getEntry(const SharedImage *image, uint32_t index, SnapshotEntry *entry)
+{
+    memcpy(entry, image->base + image->header.indexOffset + index * sizeof(SnapshotEntry), sizeof(SnapshotEntry));
+
+    return entry->categoryOffset <= image->header.stringTableSize
+           && entry->categoryLength <= image->header.stringTableSize - entry->categoryOffset
+           && entry->configOffset <= image->header.stringTableSize
+           && entry->configLength <= image->header.stringTableSize - entry->configOffset;
+}
+
+/**
+ * Compare first length bytes of "category.config" of entry with name in memcmp order
+ */
+static int snapshot_compareEntry(const SharedImage *image, const SnapshotEntry *entry, const char *name, size_t length)
+{
+    const char *category = image->strings + entry->categoryOffset;
+    const char *config = image->strings + entry->configOffset;
+    size_t fullLength = (size_t) entry->categoryLength + 1 + entry->configLength;
+    size_t compareLength = MIN(fullLength, length);
+    size_t part = MIN(compareLength, (size_t) entry->categoryLength);
+    int result = memcmp(category, name, part);
+
+    if (0 == result && compareLength > part)
+    {
+        result = (int) '.' - (int) (unsigned char) name[part];
+        if (0 == result && compareLength > part + 1)
+            result = memcmp(config, name + part + 1, compareLength - part - 1);
+    }
+
+    if (0 != result)
+        return result;
+
+    // Entry which starts with name is regarded as equal
+    return (fullLength < length) ? -1 : 0;
+}
+
+/**
+ * @return index of the first entry which is not less than first length bytes of name
+ */
+static uint32_t snapshot_lowerBound(const SharedImage *image, const char *name, size_t length)
+{
+    uint32_t low = 0, high = image->header.entryCount;
+
+    while (low < high)
+    {
+        uint32_t mid = low + (high - low) / 2;
+        SnapshotEntry entry;
+
+        if (snapshot_getEntry(image, mid, &entry) && snapshot_compareEntry(image, &entry, name, length) < 0)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return low;
+}
+
+static void snapshot_putEntry(const SharedImage *image, const SnapshotEntry *entry, jvalue_ref configs)
+{
+    uint32_t offset = entry->valueOffset;
+    jvalue_ref value = snapshot_decode(image, &offset, 0);
+    char *fullName = NULL;
+
+    if (!value)
+        return;
+
+    fullName = g_strdup_printf("%.*s.%.*s",
+                               (int) entry->categoryLength, image->strings + entry->categoryOffset,
+                               (int) entry->configLength, image->strings + entry->configOffset);
+    jobject_put(configs, jstring_create(fullName), value);
+    g_free(fullName);
+}
+
+static void snapshot_readConfig(const SharedImage *image, raw_buffer name, jvalue_ref configs)
+{
+    bool isWildcard = (name.m_len >= 2 && name.m_str[name.m_len - 1] == CONFIG_WILDCARD);
+    size_t length = isWildcard ? name.m_len - 1 : name.m_len; // "category." for wildcard
+    uint32_t index = snapshot_lowerBound(image, name.m_str, length);
+    SnapshotEntry entry;
+
+    for (; index < image->header.entryCount; index++)
+    {
+        if (!snapshot_getEntry(image, index, &entry) || snapshot_compareEntry(image, &entry, name.m_str, length) != 0)
+            break;
+
+        if (!isWildcard)
+        {
+            // Exact match only, not a longer name which starts with name
+            if ((size_t) entry.categoryLength + 1 + entry.configLength == length)
+                snapshot_putEntry(image, &entry, configs);
+            break;
+        }
+
+        // Configs of sub categories are not selected by wildcard
+        if ((size_t) entry.categoryLength + 1 == length)
+            snapshot_putEntry(image, &entry, configs);
+    }
+}
+
+bool config_readSharedSnapshot(const char *path, jvalue_ref configNames, jvalue_ref configs, uint64_t *generation)
+{
+    SharedImage image;
+    struct stat imageStat;
+    void *addr = NULL;
+    size_t size = 0;
+    int32_t index = 0;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0)
+        return false;
+
+    if (fstat(fd, &imageStat) != 0 || (size_t) imageStat.st_size < sizeof(SnapshotHeader))
+    {
+        close(fd);
+        return false;
+    }
+
+    size = imageStat.st_size;
+    addr = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == addr)
+        return false;
+
+    image.base = (const char *) addr;
+    memcpy(&image.header, image.base, sizeof(image.header));
+    image.strings = image.base + image.header.stringTableOffset;
+    image.values = image.base + image.header.valueOffset;
+
+    if (memcmp(image.header.magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_LENGTH) != 0
+        || image.header.version != SNAPSHOT_VERSION
+        || (uint64_t) image.header.stringTableOffset + image.header.stringTableSize > size
+        || (uint64_t) image.header.indexOffset + (uint64_t) image.header.entryCount * sizeof(SnapshotEntry) > size
+        || (uint64_t) image.header.valueOffset + image.header.valueSize > size)
+    {
+        LOG_LIB_INFO_PAIRS(MSGID_LIBCONFIGD, 0, "%s: invalid image %s", __FUNCTION__, path);
+        munmap(addr, size);
+        return false;
+    }
+
+    for (index = 0; index < jarray_size(configNames); index++)
+    {
+        raw_buffer name = jstring_get_fast(jarray_get(configNames, index));
+        if (name.m_str && name.m_len > 0)
+            snapshot_readConfig(&image, name, configs);
+    }
+
+    if (generation)
+        *generation = image.header.generation;
+
+    munmap(addr, size);
+    return true;
+}
@@ -0,0 +1,38 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LIBCONFIGD_SNAPSHOT_H_
+#define _LIBCONFIGD_SNAPSHOT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <pbnjson.h>
+
+/**
+ * Read requested configs from the unified database image published by configd.
+ *
+ * The image is mapped read-only and only requested configs are decoded.
+ * Wildcard names ("category.*") select all configs of the category.
+ *
+ * @param path image file (SNAPSHOT_SHARED_PATH)
+ * @param configNames jarray of config names
+ * @param configs jobject to put decoded "category.config" : value pairs
+ * @param generation generation of the image is returned if not null
+ * @return false if there is no valid image
+ */
+bool config_readSharedSnapshot(const char *path, jvalue_ref configNames, jvalue_ref configs, uint64_t *generation);
+
+#endif // _LIBCONFIGD_SNAPSHOT_H_
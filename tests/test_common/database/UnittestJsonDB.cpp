@@ -399,3 +399,153 @@ TEST_F(UnittestJsonDB, searchKey)
     ASSERT_STREQ(result[NAME_CATEGORY1 + "." + NAME_CONFIG2].asString().c_str(), NAME_CONFIG_VALUE2.c_str());
     ASSERT_STREQ(result[NAME_CATEGORY2 + "." + NAME_CONFIG2].asString().c_str(), NAME_CONFIG_VALUE2.c_str());
 }
+
+TEST_F(UnittestJsonDB, searchKeyWithLiteralPrefix)
+{
+    givenMultiItemsDB();
+    m_testDB.insert(NAME_CATEGORY1 + ".sub", NAME_CONFIG1, NAME_CONFIG_VALUE1);
+
+    JValue result = pbnjson::Object();
+    EXPECT_TRUE(m_testDB.searchKey("^" + NAME_CATEGORY1 + "\\.sub\\.", result));
+    EXPECT_EQ(1, result.objectSize());
+    EXPECT_TRUE(result.hasKey(NAME_CATEGORY1 + ".sub." + NAME_CONFIG1));
+
+    result = pbnjson::Object();
+    EXPECT_TRUE(m_testDB.searchKey("^" + NAME_CATEGORY2 + "?", result));
+    EXPECT_TRUE(result.hasKey(NAME_CATEGORY2 + "." + NAME_CONFIG2));
+    EXPECT_TRUE(result.hasKey(m_fullNameFirst));
+
+    result = pbnjson::Object();
+    EXPECT_FALSE(m_testDB.searchKey("^notExist", result));
+}
+
+TEST_F(UnittestJsonDB, fetchCategoryWithSubCategory)
+{
+    givenMultiItemsDB();
+    m_testDB.insert(NAME_CATEGORY1 + ".sub", NAME_CONFIG1, NAME_CONFIG_VALUE1);
+
+    JValue result = pbnjson::Object();
+    ASSERT_TRUE(m_testDB.fetch(NAME_CATEGORY1 + ".*", result));
+    EXPECT_EQ(3, result.objectSize());
+    EXPECT_FALSE(result.hasKey(NAME_CATEGORY1 + ".sub." + NAME_CONFIG1));
+
+    m_testDB.remove(m_fullNameFirst);
+    result = pbnjson::Object();
+    ASSERT_TRUE(m_testDB.fetch(NAME_CATEGORY1 + ".*", result));
+    EXPECT_EQ(2, result.objectSize());
+}
+
+TEST_F(UnittestJsonDB, fetchAfterRemoveAndClear)
+{
+    givenMultiItemsDB();
+
+    JValue result = pbnjson::Object();
+
+    ASSERT_TRUE(m_testDB.fetch(m_fullNameFirst, result));
+    ASSERT_TRUE(m_testDB.remove(m_fullNameFirst));
+    result = pbnjson::Object();
+    ASSERT_FALSE(m_testDB.fetch(m_fullNameFirst, result));
+    ASSERT_TRUE(m_testDB.fetch(m_fullNameSecond, result));
+
+    m_testDB.clear();
+    result = pbnjson::Object();
+    ASSERT_FALSE(m_testDB.fetch(m_fullNameSecond, result));
+}
+
+TEST_F(UnittestJsonDB, fetchAfterCopyAndMerge)
+{
+    givenMultiItemsDB();
+    givenFactoryDB();
+
+    JValue result = pbnjson::Object();
+
+    m_unifiedDB.copy(m_testDB);
+    ASSERT_TRUE(m_unifiedDB.fetch(m_fullNameFirst, result));
+    ASSERT_EQ(NAME_CONFIG_VALUE1, result[m_fullNameFirst].asString());
+
+    m_unifiedDB.merge(m_testFactoryDB);
+    result = pbnjson::Object();
+    ASSERT_TRUE(m_unifiedDB.fetch(m_fullNameFirst, result));
+    ASSERT_EQ(NAME_CONFIG_VALUE2, result[m_fullNameFirst].asString());
+}
+
+TEST_F(UnittestJsonDB, fetchUntrimmedFullName)
+{
+    givenMultiItemsDB();
+
+    JValue result = pbnjson::Object();
+
+    ASSERT_TRUE(m_testDB.fetch(" " + m_fullNameFirst, result));
+    ASSERT_EQ(NAME_CONFIG_VALUE1, result[m_fullNameFirst].asString());
+}
+
+TEST_F(UnittestJsonDB, fetchReference)
+{
+    givenMultiItemsDB();
+
+    JValue object = pbnjson::Object();
+    object.put("key", "value");
+    m_testDB.insert(m_fullNameFirst, object);
+
+    JValue result = pbnjson::Object();
+    ASSERT_TRUE(m_testDB.fetchReference(m_fullNameFirst, result));
+    ASSERT_TRUE(m_testDB.fetchReference(NAME_CATEGORY1 + ".*", result));
+    ASSERT_TRUE(result[m_fullNameFirst] == object);
+    ASSERT_EQ(NAME_CONFIG_VALUE2, result[m_fullNameSecond].asString());
+    ASSERT_FALSE(m_testDB.fetchReference("NotExist.config", result));
+}
+
+TEST_F(UnittestJsonDB, stringifyWithSerializedValues)
+{
+    givenMultiItemsDB();
+
+    JValue payload = pbnjson::Object();
+    JValue configs = pbnjson::Object();
+    ASSERT_TRUE(m_testDB.fetchReference(NAME_CATEGORY1 + ".*", configs));
+    configs.put("notInDB.config", 1);
+    payload.put("configs", configs);
+    payload.put("returnValue", true);
+    ASSERT_TRUE(JDomParser::fromString(m_testDB.stringify(payload)) == payload);
+
+    // Cached text is updated after insert
+    m_testDB.insert(m_fullNameFirst, "newValue");
+    configs = pbnjson::Object();
+    ASSERT_TRUE(m_testDB.fetchReference(m_fullNameFirst, configs));
+    payload.put("configs", configs);
+    ASSERT_EQ("newValue", JDomParser::fromString(m_testDB.stringify(payload))["configs"][m_fullNameFirst].asString());
+}
+
+TEST_F(UnittestJsonDB, diff)
+{
+    givenMultiItemsDB();
+
+    JsonDB newDB;
+    newDB.copy(m_testDB);
+    newDB.insert(NAME_CATEGORY1, NAME_CONFIG1, NAME_CONFIG_VALUE3);
+    newDB.remove(NAME_CATEGORY2, NAME_CONFIG2);
+    newDB.insert("testCategory3", NAME_CONFIG1, NAME_CONFIG_VALUE1);
+
+    set<string> changedNames;
+    JsonDB::diff(m_testDB, newDB, changedNames);
+
+    ASSERT_EQ(3, changedNames.size());
+    ASSERT_EQ(1, changedNames.count(NAME_CATEGORY1 + "." + NAME_CONFIG1));
+    ASSERT_EQ(1, changedNames.count(NAME_CATEGORY2 + "." + NAME_CONFIG2));
+    ASSERT_EQ(1, changedNames.count("testCategory3." + NAME_CONFIG1));
+}
+
+TEST_F(UnittestJsonDB, swap)
+{
+    givenMultiItemsDB();
+
+    JsonDB otherDB;
+    otherDB.insert(NAME_CATEGORY2, NAME_CONFIG1, NAME_CONFIG_VALUE1);
+    m_testDB.swap(otherDB);
+
+    JValue result = pbnjson::Object();
+    ASSERT_TRUE(m_testDB.fetch(NAME_CATEGORY2 + "." + NAME_CONFIG1, result));
+    ASSERT_FALSE(m_testDB.fetch(m_fullNameFirst, result));
+    ASSERT_TRUE(otherDB.fetch(m_fullNameFirst, result));
+    ASSERT_EQ(1, m_testDB.getDatabase().objectSize());
+    ASSERT_EQ(2, otherDB.getDatabase().objectSize());
+}
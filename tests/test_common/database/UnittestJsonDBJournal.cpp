@@ -0,0 +1,134 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+#include <pbnjson.hpp>
+
+#include "Environment.h"
+#include "database/JsonDB.h"
+#include "database/JsonDBJournal.h"
+#include "util/Platform.h"
+
+using namespace pbnjson;
+using namespace std;
+
+class UnittestJsonDBJournal : public testing::Test {
+protected:
+    UnittestJsonDBJournal()
+        : m_jsonFilename(PATH_OUTPUT "/JournalDB.json")
+    {
+        m_journalFilename = JsonDBJournal::getFilename(m_jsonFilename);
+    }
+
+    virtual ~UnittestJsonDBJournal()
+    {
+        Platform::deleteFile(m_jsonFilename);
+        Platform::deleteFile(m_journalFilename);
+    }
+
+    void givenFlushedDB(JsonDB &db)
+    {
+        db.setJournalEnabled(true);
+        db.setFilename(m_jsonFilename);
+        db.insert("com.webos.test", "string", "value");
+        db.insert("com.webos.test", "bool", true);
+        ASSERT_TRUE(db.flush());
+        ASSERT_FALSE(Platform::isFileExist(m_journalFilename));
+    }
+
+    void thenLoadedDBEquals(JsonDB &db)
+    {
+        JsonDB loaded;
+        loaded.load(m_jsonFilename);
+        ASSERT_TRUE(loaded.getDatabase() == db.getDatabase());
+        ASSERT_FALSE(loaded.isUpdated());
+    }
+
+    string m_jsonFilename;
+    string m_journalFilename;
+};
+
+TEST_F(UnittestJsonDBJournal, flushAppendsJournal)
+{
+    JsonDB db;
+    givenFlushedDB(db);
+    string contents = Platform::readFile(m_jsonFilename);
+
+    db.insert("com.webos.test", "string", "changed");
+    db.remove("com.webos.test", "bool");
+    db.insert("com.webos.other", "number", 10);
+    ASSERT_TRUE(db.flush());
+
+    // JSON file is not rewritten
+    ASSERT_TRUE(Platform::isFileExist(m_journalFilename));
+    ASSERT_EQ(contents, Platform::readFile(m_jsonFilename));
+    thenLoadedDBEquals(db);
+}
+
+TEST_F(UnittestJsonDBJournal, compactJournal)
+{
+    JsonDB db;
+    givenFlushedDB(db);
+
+    string largeValue(JsonDBJournal::MAX_SIZE / 4, 'x');
+    for (int i = 0; i < 8; i++) {
+        db.insert("com.webos.test", "large", largeValue + to_string(i));
+        ASSERT_TRUE(db.flush());
+        ASSERT_LE(JsonDBJournal::getSize(m_journalFilename), JsonDBJournal::MAX_SIZE);
+    }
+    thenLoadedDBEquals(db);
+}
+
+TEST_F(UnittestJsonDBJournal, staleJournalIsIgnored)
+{
+    JsonDB db;
+    givenFlushedDB(db);
+
+    db.insert("com.webos.test", "string", "changed");
+    ASSERT_TRUE(db.flush());
+    string journal = Platform::readFile(m_journalFilename);
+
+    // JSON file is rewritten but old journal is left behind
+    db.clear();
+    db.setFilename(m_jsonFilename);
+    db.insert("com.webos.test", "string", "cleared");
+    ASSERT_TRUE(db.flush());
+    Platform::writeFile(m_journalFilename, journal + "\n");
+
+    thenLoadedDBEquals(db);
+    ASSERT_FALSE(Platform::isFileExist(m_journalFilename));
+}
+
+TEST_F(UnittestJsonDBJournal, tornJournalIsTruncated)
+{
+    JsonDB db;
+    givenFlushedDB(db);
+
+    db.insert("com.webos.test", "string", "changed");
+    ASSERT_TRUE(db.flush());
+    string journal = Platform::readFile(m_journalFilename);
+    Platform::writeFile(m_journalFilename, journal + "\n[\"insert\", \"com.webos.te");
+
+    JsonDB loaded;
+    loaded.setJournalEnabled(true);
+    loaded.load(m_jsonFilename);
+    ASSERT_TRUE(loaded.getDatabase() == db.getDatabase());
+
+    // Torn journal is compacted in next flush
+    loaded.insert("com.webos.test", "bool", false);
+    ASSERT_TRUE(loaded.flush());
+    ASSERT_FALSE(Platform::isFileExist(m_journalFilename));
+}
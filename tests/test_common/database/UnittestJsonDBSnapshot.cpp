@@ -0,0 +1,185 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+#include <pbnjson.hpp>
+#include <sys/stat.h>
+
+#include "Environment.h"
+#include "database/JsonDB.h"
+#include "database/JsonDBSnapshot.h"
+#include "util/Platform.h"
+
+using namespace pbnjson;
+using namespace std;
+
+#define TEST_DATA_PATH "tests/test_common/database/_data"
+
+class UnittestJsonDBSnapshot : public testing::Test {
+protected:
+    UnittestJsonDBSnapshot()
+        : m_jsonFilename(PATH_OUTPUT "/SnapshotDB.json")
+    {
+        m_snapshotFilename = JsonDBSnapshot::getFilename(m_jsonFilename);
+    }
+
+    virtual ~UnittestJsonDBSnapshot()
+    {
+        Platform::deleteFile(m_jsonFilename);
+        Platform::deleteFile(m_snapshotFilename);
+    }
+
+    void givenFlushedDB()
+    {
+        JValue array = pbnjson::Array();
+        array.append(1);
+        array.append(2.5);
+        array.append(JValue());
+        array.append("three");
+
+        JValue object = pbnjson::Object();
+        object.put("enabled", true);
+        object.put("list", array);
+
+        JsonDB db;
+        db.setSnapshotEnabled(true);
+        db.setFilename(m_jsonFilename);
+        db.insert("com.webos.test", "string", "value");
+        db.insert("com.webos.test", "integer", (int64_t) 1234567890123LL);
+        db.insert("com.webos.test", "object", object);
+        db.insert("com.webos.other", "bool", false);
+        ASSERT_TRUE(db.flush());
+        m_expected = db.getDatabase().duplicate();
+    }
+
+    void thenSnapshotExists()
+    {
+        ASSERT_TRUE(Platform::isFileExist(m_snapshotFilename));
+    }
+
+    void thenSnapshotMatches()
+    {
+        struct stat source;
+        JValue database;
+
+        ASSERT_EQ(0, stat(m_jsonFilename.c_str(), &source));
+        ASSERT_TRUE(JsonDBSnapshot::read(m_snapshotFilename, source, database));
+        ASSERT_TRUE(database == m_expected);
+    }
+
+    string m_jsonFilename;
+    string m_snapshotFilename;
+    JValue m_expected;
+};
+
+TEST_F(UnittestJsonDBSnapshot, flushWritesSnapshot)
+{
+    givenFlushedDB();
+    thenSnapshotExists();
+    thenSnapshotMatches();
+}
+
+TEST_F(UnittestJsonDBSnapshot, loadFromSnapshot)
+{
+    givenFlushedDB();
+
+    JsonDB db;
+    db.setSnapshotEnabled(true);
+    db.load(m_jsonFilename);
+    ASSERT_TRUE(db.getDatabase() == m_expected);
+
+    JValue result = pbnjson::Object();
+    ASSERT_TRUE(db.fetch("com.webos.test.string", result));
+    ASSERT_STREQ("value", result["com.webos.test.string"].asString().c_str());
+}
+
+TEST_F(UnittestJsonDBSnapshot, staleSnapshotIsIgnored)
+{
+    givenFlushedDB();
+
+    // JSON file is modified without flush, so snapshot doesn't describe it anymore
+    Platform::copyFile(TEST_DATA_PATH "/SimpleDB.json", m_jsonFilename);
+
+    struct stat source;
+    JValue database;
+    ASSERT_EQ(0, stat(m_jsonFilename.c_str(), &source));
+    ASSERT_FALSE(JsonDBSnapshot::read(m_snapshotFilename, source, database));
+
+    JsonDB db;
+    db.setSnapshotEnabled(true);
+    db.load(m_jsonFilename);
+    ASSERT_TRUE(db.getDatabase().hasKey("testCategory1"));
+    ASSERT_FALSE(db.getDatabase().hasKey("com.webos.test"));
+}
+
+TEST_F(UnittestJsonDBSnapshot, corruptedSnapshotIsIgnored)
+{
+    givenFlushedDB();
+
+    struct stat source;
+    ASSERT_EQ(0, stat(m_jsonFilename.c_str(), &source));
+
+    // Truncate snapshot in the middle of the value section
+    gchar *contents = NULL;
+    gsize length = 0;
+    ASSERT_TRUE(g_file_get_contents(m_snapshotFilename.c_str(), &contents, &length, NULL));
+    ASSERT_TRUE(g_file_set_contents(m_snapshotFilename.c_str(), contents, length - 4, NULL));
+    g_free(contents);
+
+    JValue database;
+    ASSERT_FALSE(JsonDBSnapshot::read(m_snapshotFilename, source, database));
+
+    JsonDB db;
+    db.setSnapshotEnabled(true);
+    db.load(m_jsonFilename);
+    ASSERT_TRUE(db.getDatabase() == m_expected);
+}
+
+TEST_F(UnittestJsonDBSnapshot, publishSharedSnapshot)
+{
+    givenFlushedDB();
+
+    string sharedFilename = PATH_OUTPUT "/SharedSnapshot";
+    ASSERT_TRUE(JsonDBSnapshot::publish(sharedFilename, m_expected, 10));
+
+    // Shared snapshot doesn't have source JSON file
+    struct stat source;
+    JValue database;
+    memset(&source, 0, sizeof(source));
+    ASSERT_TRUE(JsonDBSnapshot::read(sharedFilename, source, database));
+    ASSERT_TRUE(database == m_expected);
+    Platform::deleteFile(sharedFilename);
+}
+
+TEST_F(UnittestJsonDBSnapshot, clearRemovesSnapshot)
+{
+    givenFlushedDB();
+
+    JsonDB db;
+    db.setSnapshotEnabled(true);
+    db.load(m_jsonFilename);
+    db.clear();
+    ASSERT_FALSE(Platform::isFileExist(m_snapshotFilename));
+}
+
+TEST_F(UnittestJsonDBSnapshot, snapshotIsDisabledByDefault)
+{
+    JsonDB db;
+    db.setFilename(m_jsonFilename);
+    db.insert("com.webos.test", "string", "value");
+    ASSERT_TRUE(db.flush());
+    ASSERT_FALSE(Platform::isFileExist(m_snapshotFilename));
+}
@@ -19,6 +19,7 @@
 
 #include "Environment.h"
 #include "util/Json.h"
+#include "util/Platform.h"
 
 using namespace pbnjson;
 using namespace std;
@@ -121,3 +122,24 @@ TEST_F(UnittestJson, getValueWithKeys)
     ASSERT_TRUE(Json::getValueWithKeys(root, keys, result));
     ASSERT_STREQ(result.asString().c_str(), "test2");
 }
+
+TEST_F(UnittestJson, getSchema)
+{
+    const JSchema &schema = Json::getSchema(GETCONFIGS_SCHEMA);
+    ASSERT_TRUE(schema.isInitialized());
+    ASSERT_EQ(&schema, &Json::getSchema(GETCONFIGS_SCHEMA));
+
+    JValue valid = JDomParser::fromString("{ \"configNames\": [ \"com.webos.test.key\" ] }", schema);
+    ASSERT_FALSE(valid.isNull());
+}
+
+TEST_F(UnittestJson, getSchemaNotCachedIfFailed)
+{
+    string filename = PATH_OUTPUT "/late.schema";
+    Platform::deleteFile(filename);
+    ASSERT_FALSE(Json::getSchema(filename).isInitialized());
+
+    ASSERT_TRUE(Platform::writeFile(filename, "{ \"type\": \"object\" }"));
+    EXPECT_TRUE(Json::getSchema(filename).isInitialized());
+    Platform::deleteFile(filename);
+}
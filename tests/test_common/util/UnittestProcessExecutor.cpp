@@ -0,0 +1,140 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+#include <signal.h>
+
+#include "Environment.h"
+#include "util/ProcessExecutor.h"
+
+using namespace std;
+
+class UnittestProcessExecutor : public testing::Test {
+protected:
+    UnittestProcessExecutor()
+    {
+    }
+
+    virtual ~UnittestProcessExecutor()
+    {
+    }
+
+    void whenExecute(const string &command, int timeout = ProcessExecutor::MS_DEFAULT_TIMEOUT)
+    {
+        vector<string> args;
+        args.push_back("FIRST");
+        args.push_back("SECOND");
+
+        ASSERT_TRUE(m_executor.start(command, args, timeout));
+        m_executor.wait();
+        ASSERT_FALSE(m_executor.isRunning());
+    }
+
+    ProcessExecutor m_executor;
+};
+
+TEST_F(UnittestProcessExecutor, executeWithArgs)
+{
+    whenExecute("echo 'first arg'");
+    EXPECT_EQ(0, m_executor.getExitStatus());
+    EXPECT_FALSE(m_executor.isTimeout());
+    EXPECT_EQ("first arg FIRST SECOND\n", m_executor.getOutput());
+}
+
+TEST_F(UnittestProcessExecutor, executeShellCommand)
+{
+    whenExecute("echo $((1 + 2)); exit 3;");
+    EXPECT_EQ(3, m_executor.getExitStatus());
+    EXPECT_EQ("3\n", m_executor.getOutput());
+}
+
+TEST_F(UnittestProcessExecutor, executeShellBuiltin)
+{
+    ASSERT_TRUE(m_executor.start("exit 4", vector<string>()));
+    m_executor.wait();
+    EXPECT_EQ(4, m_executor.getExitStatus());
+}
+
+TEST_F(UnittestProcessExecutor, executeDirectly)
+{
+    vector<string> args;
+    args.push_back("FIRST SECOND");
+
+    // Argument is not split without shell
+    m_executor.setDirect(true);
+    ASSERT_TRUE(m_executor.start("printf %s-", args));
+    m_executor.wait();
+    EXPECT_EQ("FIRST SECOND-", m_executor.getOutput());
+
+    // Builtins need shell
+    EXPECT_FALSE(m_executor.start("exit 4", vector<string>()));
+}
+
+TEST_F(UnittestProcessExecutor, executeInvalidCommand)
+{
+    vector<string> args;
+
+    // Shell reports it as exit status like popen
+    ASSERT_TRUE(m_executor.start("notExistCommand", args));
+    m_executor.wait();
+    EXPECT_EQ(127, m_executor.getExitStatus());
+
+    m_executor.setDirect(true);
+    EXPECT_FALSE(m_executor.start("notExistCommand", args));
+    EXPECT_FALSE(m_executor.isRunning());
+}
+
+TEST_F(UnittestProcessExecutor, timeout)
+{
+    whenExecute("sleep 10", 100);
+    EXPECT_TRUE(m_executor.isTimeout());
+    EXPECT_EQ(-1, m_executor.getExitStatus());
+}
+
+TEST_F(UnittestProcessExecutor, waitAllConcurrently)
+{
+    ProcessExecutor first, second;
+    vector<ProcessExecutor*> executors;
+    vector<string> args;
+
+    executors.push_back(&first);
+    executors.push_back(&second);
+    gint64 start = g_get_monotonic_time();
+    ASSERT_TRUE(first.start("sleep 0.3", args));
+    ASSERT_TRUE(second.start("sleep 0.3", args));
+    ProcessExecutor::waitAll(executors);
+
+    EXPECT_LT(g_get_monotonic_time() - start, 550 * G_TIME_SPAN_MILLISECOND);
+    EXPECT_EQ(0, first.getExitStatus());
+    EXPECT_EQ(0, second.getExitStatus());
+}
+
+TEST_F(UnittestProcessExecutor, inputNotReadByProcess)
+{
+    vector<string> args;
+    struct sigaction action;
+
+    // Larger than pipe buffer, so write fails after the process exits
+    m_executor.setInput(string(1024 * 1024, 'x'));
+    ASSERT_TRUE(m_executor.start("head -c 3", args));
+    EXPECT_TRUE(m_executor.wait());
+    EXPECT_EQ(0, m_executor.getExitStatus());
+    EXPECT_EQ("xxx", m_executor.getOutput());
+
+    // SIGPIPE of the write is not delivered, and its disposition is not changed
+    ASSERT_EQ(0, sigaction(SIGPIPE, NULL, &action));
+    EXPECT_EQ(SIG_DFL, action.sa_handler);
+}
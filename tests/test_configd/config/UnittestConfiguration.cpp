@@ -19,6 +19,7 @@
 
 #include "Environment.h"
 #include "config/Configuration.h"
+#include "util/Platform.h"
 
 #include "MockLayer.h"
 #include "service/MockAbstractBusFactory.h"
@@ -38,7 +39,10 @@ protected:
 
     virtual ~UnittestConfiguration()
     {
-
+        for (const string &filename : m_outputFiles)
+            Platform::deleteFile(filename);
+        g_rmdir(PATH_OUTPUT_LAYER_NONE);
+        g_rmdir(PATH_OUTPUT_LAYERS);
     }
 
     void givenDefaultConfiguration()
@@ -66,6 +70,30 @@ protected:
 
     }
 
+    // Same as default configuration, but the lowest layer is a copy under PATH_OUTPUT
+    void givenWritableConfiguration()
+    {
+        JValue data = pbnjson::JDomParser::fromFile(PATH_LAYERS_DEAULT);
+        string sourceDir = data["layers"][0]["base_dir"].asString();
+
+        ASSERT_EQ(0, g_mkdir_with_parents(PATH_OUTPUT_LAYER_NONE, 0755));
+        GDir *dir = g_dir_open(sourceDir.c_str(), 0, NULL);
+        ASSERT_TRUE(NULL != dir);
+        const gchar *name;
+        while ((name = g_dir_read_name(dir)) != NULL) {
+            string filename = Platform::concatPaths(PATH_OUTPUT_LAYER_NONE, name);
+            m_outputFiles.push_back(filename);
+            ASSERT_TRUE(Platform::copyFile(Platform::concatPaths(sourceDir, name), filename));
+        }
+        g_dir_close(dir);
+
+        data["layers"][0].put("base_dir", PATH_OUTPUT_LAYER_NONE);
+        m_outputFiles.push_back(PATH_LAYERS_WRITABLE);
+        ASSERT_TRUE(Platform::writeFile(PATH_LAYERS_WRITABLE, data.stringify("    ")));
+        m_configuration.clear();
+        m_configuration.append(PATH_LAYERS_WRITABLE);
+    }
+
     void givenArrayPostProcess()
     {
         JSchema schema = JSchema::fromFile(CONFIGLAYERS_SCHEMA);
@@ -73,8 +101,21 @@ protected:
         m_configuration.append(PATH_LAYERS_ARRAY_POST_PROCESS);
     }
 
+    void givenJsonPostProcess()
+    {
+        m_configuration.clear();
+        m_configuration.append(PATH_LAYERS_JSON_POST_PROCESS);
+    }
+
+    void givenStreamPostProcess()
+    {
+        m_configuration.clear();
+        m_configuration.append(PATH_LAYERS_STREAM_POST_PROCESS);
+    }
+
     Configuration &m_configuration;
     std::vector<std::string> m_baseDirs;
+    std::vector<std::string> m_outputFiles;
 
     MockLayerListener m_listener;
     MockAbstractBusFactory m_factory;
@@ -83,7 +124,12 @@ protected:
     const char *PATH_LAYERS_MULTI = TEST_DATA_PATH "/layers/layers_multi.json";
 
     const char *PATH_LAYERS_ARRAY_POST_PROCESS = TEST_DATA_PATH "/layers/layers_array_post_process.json";
+    const char *PATH_LAYERS_JSON_POST_PROCESS = TEST_DATA_PATH "/layers/layers_json_post_process.json";
+    const char *PATH_LAYERS_STREAM_POST_PROCESS = TEST_DATA_PATH "/layers/layers_stream_post_process.json";
     const char *PATH_JSON_DB = PATH_OUTPUT "/prepostprocess_jsondb.json";
+    const char *PATH_OUTPUT_LAYERS = PATH_OUTPUT "/layers";
+    const char *PATH_OUTPUT_LAYER_NONE = PATH_OUTPUT "/layers/layer_none";
+    const char *PATH_LAYERS_WRITABLE = PATH_OUTPUT "/layers_writable.json";
 
     const char *CONFIG_CATEGORY_NAME1 = "com.webos.component1";
     const char *CONFIG_CATEGORY_NAME2 = "com.webos.component2";
@@ -253,6 +299,60 @@ TEST_F(UnittestConfiguration, FetchMultiLayer)
 
 }
 
+TEST_F(UnittestConfiguration, FetchChangedConfigsWithoutChange)
+{
+    givenDefaultConfiguration();
+
+    JsonDB fullDB;
+    JsonDB changedDB;
+    JsonDB permissionDB;
+    m_configuration.selectAll();
+    m_configuration.fetchConfigs(fullDB, &permissionDB);
+    m_configuration.fetchChangedConfigs(changedDB, &permissionDB);
+
+    EXPECT_TRUE(fullDB.getDatabase() == changedDB.getDatabase());
+}
+
+TEST_F(UnittestConfiguration, FetchChangedConfigsAfterSelection)
+{
+    givenDefaultConfiguration();
+
+    JsonDB oldDB;
+    JsonDB changedDB;
+    JsonDB fullDB;
+    JsonDB permissionDB;
+    m_configuration.selectAll();
+    m_configuration.fetchConfigs(oldDB, &permissionDB);
+
+    Layer *layerFile = m_configuration.getLayer("file");
+    ASSERT_TRUE(NULL != layerFile);
+    ASSERT_TRUE(layerFile->setSelection("selection2"));
+    m_configuration.fetchChangedConfigs(changedDB, &permissionDB);
+    m_configuration.fetchConfigs(fullDB, &permissionDB);
+
+    EXPECT_TRUE(fullDB.getDatabase() == changedDB.getDatabase());
+}
+
+TEST_F(UnittestConfiguration, FetchChangedConfigsAfterFileChange)
+{
+    givenWritableConfiguration();
+
+    JsonDB oldDB;
+    JsonDB changedDB;
+    JsonDB permissionDB;
+    m_configuration.selectAll();
+    m_configuration.fetchConfigs(oldDB, &permissionDB);
+
+    // The lowest layer gets a new file without any selection change
+    string filename = Platform::concatPaths(PATH_OUTPUT_LAYER_NONE, "com.webos.component5.json");
+    m_outputFiles.push_back(filename);
+    ASSERT_TRUE(Platform::writeFile(filename, "{ \"addedKey\": true }"));
+    m_configuration.fetchChangedConfigs(changedDB, &permissionDB);
+
+    EXPECT_FALSE(oldDB.getDatabase().hasKey("com.webos.component5"));
+    EXPECT_TRUE(changedDB.getDatabase().hasKey("com.webos.component5"));
+}
+
 TEST_F(UnittestConfiguration, PreProcess)
 {
     givenDefaultConfiguration();
@@ -279,3 +379,39 @@ TEST_F(UnittestConfiguration, AdditionalPostProcess)
     jsonDB.setFilename(PATH_JSON_DB);
     ASSERT_TRUE(m_configuration.runPostProcess(jsonDB));
 }
+
+TEST_F(UnittestConfiguration, JsonPostProcess)
+{
+    givenJsonPostProcess();
+
+    JsonDB jsonDB;
+    jsonDB.insert(CONFIG_CATEGORY_NAME1, CONFIG_KEY, CONFIG_VALUE);
+    jsonDB.insert(CONFIG_CATEGORY_NAME1, "key2", CONFIG_VALUE_MULTILAYER);
+    ASSERT_TRUE(m_configuration.runPostProcess(jsonDB));
+
+    JValue result = pbnjson::Object();
+    ASSERT_TRUE(jsonDB.fetch(CONFIG_CATEGORY_NAME1, "supportHDR", result));
+    EXPECT_FALSE(jsonDB.fetch(CONFIG_CATEGORY_NAME1, "unmatchedKey", result));
+    EXPECT_TRUE(jsonDB.fetch(CONFIG_CATEGORY_NAME1, "combinedKey", result));
+    EXPECT_FALSE(jsonDB.fetch(CONFIG_CATEGORY_NAME1, "key2", result));
+
+    result = pbnjson::Object();
+    ASSERT_TRUE(jsonDB.fetch(CONFIG_CATEGORY_NAME2, "copiedKey", result));
+    EXPECT_STREQ(CONFIG_VALUE, result["com.webos.component2.copiedKey"].asString().c_str());
+}
+
+TEST_F(UnittestConfiguration, StreamPostProcess)
+{
+    givenStreamPostProcess();
+
+    JsonDB jsonDB;
+    jsonDB.insert(CONFIG_CATEGORY_NAME1, CONFIG_KEY, CONFIG_VALUE);
+    jsonDB.insert(CONFIG_CATEGORY_NAME2, CONFIG_KEY, CONFIG_VALUE_MULTILAYER);
+    ASSERT_TRUE(m_configuration.runPostProcess(jsonDB));
+
+    JValue result = pbnjson::Object();
+    ASSERT_TRUE(jsonDB.fetch(CONFIG_CATEGORY_NAME1, CONFIG_KEY, result));
+    EXPECT_STREQ("streamed", result["com.webos.component1.key1"].asString().c_str());
+    ASSERT_TRUE(jsonDB.fetch(CONFIG_CATEGORY_NAME2, CONFIG_KEY, result));
+    EXPECT_STREQ(CONFIG_VALUE_MULTILAYER, result["com.webos.component2.key1"].asString().c_str());
+}
@@ -63,6 +63,37 @@ protected:
         m_where.put("prop", MATCHED_CONFIG_KEY_FULL);
     }
 
+    void givenNumberDB()
+    {
+        m_jsonDB.insert(CATEGORY_NAME, NUMBER_CONFIG_KEY, NUMBER_CONFIG_VALUE);
+    }
+
+    JValue createWhere(const string &prop, const string &op, JValue val)
+    {
+        JValue where = pbnjson::Object();
+        where.put("prop", prop);
+        where.put("op", op);
+        where.put("val", val);
+        return where;
+    }
+
+    JValue createGroup(const string &op, JValue first, JValue second)
+    {
+        JValue group = pbnjson::Object();
+        JValue conditions = pbnjson::Array();
+        conditions.append(first);
+        conditions.append(second);
+        group.put(op, conditions);
+        return group;
+    }
+
+    void thenMatched(JValue where, bool expected)
+    {
+        Matcher condition(where);
+        ASSERT_TRUE(condition.validateCondition());
+        ASSERT_EQ(expected, condition.checkCondition(&m_jsonDB));
+    }
+
     JValue m_where;
     JsonDB m_jsonDB;
     JValue m_database;
@@ -75,6 +106,10 @@ protected:
 
     const string INVALID_CONFIG_KEY = "not existed";
     const string INVALID_CONFIG_KEY_FULL = MATCHED_CONFIG_KEY + "." + "not existed";
+    const string NUMBER_CONFIG_KEY = "number";
+    const string NUMBER_CONFIG_KEY_FULL = CATEGORY_NAME + "." + "number";
+    const int NUMBER_CONFIG_VALUE = 10;
+
     const string VALID_OPERATION = "=";
     const string INVALID_OPERATION = "*";
 };
@@ -115,3 +150,107 @@ TEST_F(UnittestMatcher, isNotExistProp)
     Matcher condition(m_where);
     ASSERT_FALSE(condition.checkCondition(&m_jsonDB));
 }
+
+TEST_F(UnittestMatcher, isNotEqual)
+{
+    givenDB();
+
+    thenMatched(createWhere(MATCHED_CONFIG_KEY_FULL, "!=", UNMATCHED_CONFIG_VALUE), true);
+    thenMatched(createWhere(MATCHED_CONFIG_KEY_FULL, "!=", MATCHED_CONFIG_VALUE), false);
+    thenMatched(createWhere(INVALID_CONFIG_KEY_FULL, "!=", MATCHED_CONFIG_VALUE), false);
+}
+
+TEST_F(UnittestMatcher, isIn)
+{
+    givenDB();
+
+    JValue values = pbnjson::Array();
+    values.append(UNMATCHED_CONFIG_VALUE);
+    values.append(MATCHED_CONFIG_VALUE);
+    thenMatched(createWhere(MATCHED_CONFIG_KEY_FULL, "in", values), true);
+
+    values = pbnjson::Array();
+    values.append(UNMATCHED_CONFIG_VALUE);
+    thenMatched(createWhere(MATCHED_CONFIG_KEY_FULL, "in", values), false);
+
+    Matcher condition(createWhere(MATCHED_CONFIG_KEY_FULL, "in", MATCHED_CONFIG_VALUE));
+    ASSERT_FALSE(condition.validateCondition());
+}
+
+TEST_F(UnittestMatcher, isLessOrGreater)
+{
+    givenDB();
+    givenNumberDB();
+
+    thenMatched(createWhere(NUMBER_CONFIG_KEY_FULL, "<", 20), true);
+    thenMatched(createWhere(NUMBER_CONFIG_KEY_FULL, "<", 10), false);
+    thenMatched(createWhere(NUMBER_CONFIG_KEY_FULL, ">", 5.5), true);
+    thenMatched(createWhere(NUMBER_CONFIG_KEY_FULL, ">=", 10), true);
+    thenMatched(createWhere(NUMBER_CONFIG_KEY_FULL, "<=", 9), false);
+    // String and number can't be compared
+    thenMatched(createWhere(MATCHED_CONFIG_KEY_FULL, "<", 20), false);
+}
+
+TEST_F(UnittestMatcher, isPrefix)
+{
+    givenDB();
+
+    thenMatched(createWhere(MATCHED_CONFIG_KEY_FULL, "prefix", "val"), true);
+    thenMatched(createWhere(MATCHED_CONFIG_KEY_FULL, "prefix", "value2"), false);
+    thenMatched(createWhere(NUMBER_CONFIG_KEY_FULL, "prefix", "1"), false);
+}
+
+TEST_F(UnittestMatcher, isAndOrNot)
+{
+    givenDB();
+    givenNumberDB();
+
+    JValue matched = createWhere(MATCHED_CONFIG_KEY_FULL, "=", MATCHED_CONFIG_VALUE);
+    JValue unmatched = createWhere(MATCHED_CONFIG_KEY_FULL, "=", UNMATCHED_CONFIG_VALUE);
+
+    thenMatched(createGroup("and", matched, createWhere(NUMBER_CONFIG_KEY_FULL, ">", 5)), true);
+    thenMatched(createGroup("and", matched, unmatched), false);
+    thenMatched(createGroup("or", unmatched, matched), true);
+
+    JValue notWhere = pbnjson::Object();
+    notWhere.put("not", unmatched);
+    thenMatched(notWhere, true);
+}
+
+TEST_F(UnittestMatcher, sharedProperties)
+{
+    givenDB();
+
+    Matcher::Properties properties;
+    Matcher first(createWhere(MATCHED_CONFIG_KEY_FULL, "=", MATCHED_CONFIG_VALUE));
+    Matcher second(createWhere(MATCHED_CONFIG_KEY_FULL, "!=", MATCHED_CONFIG_VALUE));
+
+    ASSERT_TRUE(first.checkCondition(&m_jsonDB, properties));
+    ASSERT_EQ(1u, properties.size());
+
+    // Property is fetched already. Changed value is not seen in the same properties.
+    m_jsonDB.insert(CATEGORY_NAME, MATCHED_CONFIG_KEY, UNMATCHED_CONFIG_VALUE);
+    ASSERT_FALSE(second.checkCondition(&m_jsonDB, properties));
+    ASSERT_TRUE(second.checkCondition(&m_jsonDB));
+}
+
+TEST_F(UnittestMatcher, invalidateProperties)
+{
+    givenDB();
+
+    Matcher::Properties properties;
+    Matcher matched(createWhere(MATCHED_CONFIG_KEY_FULL, "=", MATCHED_CONFIG_VALUE));
+    Matcher unmatched(createWhere(MATCHED_CONFIG_KEY_FULL, "=", UNMATCHED_CONFIG_VALUE));
+
+    ASSERT_TRUE(matched.checkCondition(&m_jsonDB, properties));
+    m_jsonDB.insert(CATEGORY_NAME, MATCHED_CONFIG_KEY, UNMATCHED_CONFIG_VALUE);
+
+    // Properties of other categories are kept
+    Matcher::invalidateProperties(properties, "com.webos.test2");
+    ASSERT_EQ(1u, properties.size());
+    ASSERT_FALSE(unmatched.checkCondition(&m_jsonDB, properties));
+
+    Matcher::invalidateProperties(properties, CATEGORY_NAME);
+    ASSERT_EQ(0u, properties.size());
+    ASSERT_TRUE(unmatched.checkCondition(&m_jsonDB, properties));
+}
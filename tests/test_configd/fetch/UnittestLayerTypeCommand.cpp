@@ -50,6 +50,33 @@ protected:
         givenLayer();
     }
 
+    virtual void givenAsyncSelector(const string &command, int timeout)
+    {
+        Layer::setAsyncSelectorEnabled(true);
+        givenSelector(command, timeout);
+    }
+
+    virtual void givenSelector(const string &command, int timeout)
+    {
+        givenInfo(COMMAND_ONE_NAME, command);
+        m_info["selector"].put("timeout", timeout);
+        m_info["selector"].put("alternative", pbnjson::Object());
+        m_info["selector"]["alternative"].put("string", COMMAND_TWO_RESULT);
+        givenLayer();
+    }
+
+    virtual ~UnittestLayerTypeCommand()
+    {
+        Layer::setAsyncSelectorEnabled(false);
+    }
+
+    void whenWaitSelection()
+    {
+        gint64 deadline = g_get_monotonic_time() + 3 * G_TIME_SPAN_SECOND;
+        while (!m_layer->isSelected() && g_get_monotonic_time() < deadline)
+            g_main_context_iteration(NULL, TRUE);
+    }
+
     const string COMMAND_ONE_NAME = "CommandOneLayer";
     const string COMMAND_ONE_VALUE = "echo 'selection1'";
     const string COMMAND_ONE_RESULT = "selection1";
@@ -142,6 +169,37 @@ TEST_F(UnittestLayerTypeCommand, clearSelectAndSelectAgain)
     thenSelectedStatus(TEST_DATA_PATH, COMMAND_ONE_RESULT);
 }
 
+TEST_F(UnittestLayerTypeCommand, asyncSelection)
+{
+    givenAsyncSelector(COMMAND_ONE_VALUE, ProcessExecutor::MS_DEFAULT_TIMEOUT);
+
+    EXPECT_CALL(m_listener, onSelectionChanged(_, _, _));
+    m_layer->select();
+    EXPECT_FALSE(m_layer->isSelected());
+
+    whenWaitSelection();
+    thenSelectedStatus(TEST_DATA_PATH, COMMAND_ONE_RESULT);
+}
+
+TEST_F(UnittestLayerTypeCommand, asyncSelectionTimeout)
+{
+    givenAsyncSelector("sleep 10; echo 'selection1'", 100);
+
+    m_layer->select();
+    whenWaitSelection();
+    thenSelectedStatus(TEST_DATA_PATH, COMMAND_TWO_RESULT);
+}
+
+TEST_F(UnittestLayerTypeCommand, selectionTimeout)
+{
+    givenSelector("sleep 10; echo 'selection1'", 100);
+
+    gint64 start = g_get_monotonic_time();
+    m_layer->select();
+    EXPECT_GT(3 * G_TIME_SPAN_SECOND, g_get_monotonic_time() - start);
+    thenSelectedStatus(TEST_DATA_PATH, COMMAND_TWO_RESULT);
+}
+
 TEST_F(UnittestLayerTypeCommand, invalidCallOperation)
 {
     givenCMDOneLayer();
@@ -111,3 +111,22 @@ TEST_F(UnittestLayerTypeNone, fetchFilesNotExistJsonInDir)
     JsonDB A;
     EXPECT_TRUE(Layer::parseFiles(path, NULL, &A));
 }
+
+TEST_F(UnittestLayerTypeNone, parseFilesAfterFileChanged)
+{
+    string dirPath = PATH_OUTPUT "/layer_cache";
+    string filePath = dirPath + "/com.webos.cache.json";
+    ASSERT_EQ(0, g_mkdir_with_parents(dirPath.c_str(), 0755));
+
+    JsonDB firstDB;
+    ASSERT_TRUE(Platform::writeFile(filePath, "{ \"key\": \"old\" }"));
+    ASSERT_TRUE(Layer::parseFiles(dirPath, NULL, &firstDB));
+    EXPECT_STREQ("old", firstDB.getDatabase()["com.webos.cache"]["key"].asString().c_str());
+
+    JsonDB secondDB;
+    ASSERT_TRUE(Platform::writeFile(filePath, "{ \"key\": \"changed\" }"));
+    ASSERT_TRUE(Layer::parseFiles(dirPath, NULL, &secondDB));
+    EXPECT_STREQ("changed", secondDB.getDatabase()["com.webos.cache"]["key"].asString().c_str());
+
+    Platform::deleteFile(filePath);
+}
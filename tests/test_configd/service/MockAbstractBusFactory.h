@@ -58,6 +58,7 @@ public:
     MOCK_METHOD0(isSubscription, bool());
     MOCK_METHOD1(respond, void(JValue response));
     MOCK_METHOD0(clientName, string());
+    MOCK_METHOD0(getUniqueToken, string());
 
     MockIMessage()
     {
@@ -132,7 +133,7 @@ public:
             .WillByDefault(Return(m_mockIHandle));
         ON_CALL(*this, getIMessage(_))
             .WillByDefault(Return(m_mockIMessage));
-        ON_CALL(*this, getIMessages("getConfigs"))
+        ON_CALL(*this, getIMessages(_))
             .WillByDefault(Return(m_mockIMessages));
 
         m_mockIMessages->givenMessage(m_mockIMessage);
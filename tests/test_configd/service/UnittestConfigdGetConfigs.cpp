@@ -320,3 +320,53 @@ TEST_F(UnittestConfigdGetConfigs, subscriptionMutiple)
         JsonDB::getUnifiedInstance().copy(newDB);
     }
 }
+
+TEST_F(UnittestConfigdGetConfigs, subscriptionNotNotifiedWithoutChange)
+{
+    JValue configNames = pbnjson::Array();
+    configNames.append("com.webos.category1.key2");
+    givenClientRequest(configNames, true);
+
+    EXPECT_CALL(*m_factory.getMockIMessage(), isSubscription())
+        .WillOnce(Return(true));
+    EXPECT_CALL(m_listener, onGetConfigs())
+        .WillOnce(Return(ErrorDB::ERRORCODE_NOERROR));
+    EXPECT_CALL(m_factory, getIMessages("getConfigs/com.webos.category1.key2"));
+    Configd::getInstance()->getConfigs(m_factory.getMessage());
+
+    JsonDB database;
+    database.copy(JsonDB::getUnifiedInstance());
+    database.insert("com.webos.category3", "key1", "value1");
+
+    EXPECT_CALL(m_factory, getIMessages(_))
+        .Times(0);
+    Configd::getInstance()->postGetConfigs(database, JsonDB::getUnifiedInstance());
+}
+
+TEST_F(UnittestConfigdGetConfigs, subscriptionNameIsPrunedWithoutSubscriber)
+{
+    JValue configNames = pbnjson::Array();
+    configNames.append("com.webos.category1.key3");
+    givenClientRequest(configNames, true);
+
+    EXPECT_CALL(*m_factory.getMockIMessage(), isSubscription())
+        .WillOnce(Return(true));
+    EXPECT_CALL(m_listener, onGetConfigs())
+        .WillOnce(Return(ErrorDB::ERRORCODE_NOERROR));
+    EXPECT_CALL(m_factory, getIMessages("getConfigs/com.webos.category1.key3"));
+    Configd::getInstance()->getConfigs(m_factory.getMessage());
+
+    JsonDB database;
+    database.copy(JsonDB::getUnifiedInstance());
+    database.insert("com.webos.category1", "key3", "changedValue");
+
+    // Client cancelled subscription, so nobody is visited
+    EXPECT_CALL(m_factory, getIMessages("getConfigs/com.webos.category1.key3"));
+    EXPECT_CALL(*m_factory.getMockIMessages(), each(_, _, _))
+        .WillOnce(Return(true));
+    Configd::getInstance()->postGetConfigs(database, JsonDB::getUnifiedInstance());
+
+    EXPECT_CALL(m_factory, getIMessages(_))
+        .Times(0);
+    Configd::getInstance()->postGetConfigs(database, JsonDB::getUnifiedInstance());
+}
@@ -0,0 +1,118 @@
+// Copyright (c) 2026 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+#include <pbnjson.hpp>
+
+#include "Environment.h"
+#include "database/JsonDB.h"
+#include "service/PermissionMatcher.h"
+
+using namespace pbnjson;
+using namespace std;
+
+#define TEST_DATA_PATH "tests/test_configd/service/_data"
+
+class UnittestPermissionMatcher : public testing::Test {
+protected:
+    UnittestPermissionMatcher()
+        : m_matcher("read")
+    {
+        m_permissionDB.load(TEST_DATA_PATH "/configd_permissions_db.json");
+    }
+
+    virtual ~UnittestPermissionMatcher()
+    {
+    }
+
+    void givenPermission(const string &fullName, const string &serviceName)
+    {
+        JValue permission = pbnjson::Object();
+        permission.put("read", pbnjson::Array());
+        permission["read"].append(serviceName);
+        ASSERT_TRUE(m_permissionDB.insert(fullName, permission));
+    }
+
+    PermissionMatcher m_matcher;
+    JsonDB m_permissionDB;
+};
+
+TEST_F(UnittestPermissionMatcher, matchPrefix)
+{
+    JValue permissions = pbnjson::Object();
+    permissions.put("read", pbnjson::Array());
+    permissions["read"].append("com.webos.*");
+    permissions["read"].append("com.webos.service.*");
+    permissions["read"].append("app1");
+
+    PermissionMatcher::Permission permission(permissions, "read");
+    EXPECT_TRUE(permission.match("com.webos."));
+    EXPECT_TRUE(permission.match("com.webos.service.config"));
+    EXPECT_TRUE(permission.match("app1"));
+    EXPECT_FALSE(permission.match("app1-1"));
+    EXPECT_FALSE(permission.match("com.webos"));
+    EXPECT_FALSE(permission.match(""));
+
+    permissions["read"].append("*");
+    EXPECT_TRUE(PermissionMatcher::Permission(permissions, "read").match("app2"));
+    EXPECT_TRUE(PermissionMatcher::Permission(permissions, "write").match("app2"));
+}
+
+TEST_F(UnittestPermissionMatcher, hasPermission)
+{
+    EXPECT_TRUE(m_matcher.hasPermission(m_permissionDB, "com.webos.category1.key1", "com.webos.service.config"));
+    EXPECT_TRUE(m_matcher.hasPermission(m_permissionDB, "com.webos.category1.key1", "app1-2"));
+    EXPECT_FALSE(m_matcher.hasPermission(m_permissionDB, "com.webos.category1.key1", "app2"));
+    EXPECT_TRUE(m_matcher.hasPermission(m_permissionDB, "com.webos.category1.key2", "app2"));
+    EXPECT_FALSE(m_matcher.hasPermission(m_permissionDB, "com.webos.category2.key1", "app1"));
+
+    // Config without permission
+    EXPECT_TRUE(m_matcher.hasPermission(m_permissionDB, "com.webos.category3.key1", "app2"));
+}
+
+TEST_F(UnittestPermissionMatcher, recompileAfterUpdate)
+{
+    EXPECT_FALSE(m_matcher.hasPermission(m_permissionDB, "com.webos.category2.key1", "app1"));
+
+    givenPermission("com.webos.category2.key1", "app1");
+    EXPECT_TRUE(m_matcher.hasPermission(m_permissionDB, "com.webos.category2.key1", "app1"));
+    EXPECT_FALSE(m_matcher.hasPermission(m_permissionDB, "com.webos.category2.key1", "app2"));
+
+    m_permissionDB.remove("com.webos.category2.key1");
+    EXPECT_TRUE(m_matcher.hasPermission(m_permissionDB, "com.webos.category2.key1", "app2"));
+}
+
+TEST_F(UnittestPermissionMatcher, getPublicConfigs)
+{
+    JValue database = pbnjson::Object();
+    database.put("com.webos.category1", pbnjson::Object());
+    database["com.webos.category1"].put("key1", "value1");
+    database["com.webos.category1"].put("key2", "value2");
+    database.put("com.webos.category3", pbnjson::Object());
+    database["com.webos.category3"].put("key1", "value1");
+
+    JValue publicConfigs = m_matcher.getPublicConfigs(m_permissionDB, database);
+    EXPECT_FALSE(publicConfigs["com.webos.category1"].hasKey("key1"));
+    EXPECT_EQ("value2", publicConfigs["com.webos.category1"]["key2"].asString());
+    EXPECT_EQ("value1", publicConfigs["com.webos.category3"]["key1"].asString());
+
+    // Original database is not changed
+    EXPECT_TRUE(database["com.webos.category1"].hasKey("key1"));
+
+    givenPermission("com.webos.category3.key1", "app1");
+    publicConfigs = m_matcher.getPublicConfigs(m_permissionDB, database);
+    EXPECT_FALSE(publicConfigs["com.webos.category3"].hasKey("key1"));
+}